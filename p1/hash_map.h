@@ -0,0 +1,1073 @@
+// 通用哈希表模板 HashMap<Key, Value, Hash, Policy>
+//
+// 冲突处理策略与散列函数均在编译期选定:
+//   Policy = ChainingPolicy        拉链法(质数桶数, 结点池分配)
+//   Policy = OpenAddressingPolicy  开放定址法(SwissTable 风格控制字节)
+//   Hash   = 任何提供 unsigned long long operator()(const Key &) const 的函数对象
+// 查找、插入、删除均为模板代码, 对具体的键类型与散列函数展开内联,
+// 不经过虚函数或函数指针。键须支持 == 比较与赋值, 键与值须可默认构造。
+// 两种策略都采用渐进式扩缩容: 旧表保留到迁移完毕, 期间查找同时检查新旧两张表。
+#ifndef P1_HASH_MAP_H
+#define P1_HASH_MAP_H
+
+#include <cstring>
+
+// 乘法散列常数(黄金分割共轭 × 2^32)
+const unsigned long long HASH_MULTIPLIER = 2654435769ULL;
+
+// 初始桶数(质数)
+const int HASH_TABLE_SIZE = 997;
+
+// 扩容/缩容时依次选用的质数桶数(每级约翻倍)
+const int BUCKET_PRIMES[] = {
+    997, 1997, 4001, 8009, 16033, 32069, 64151, 128311, 256639, 513283,
+    1026577, 2053189, 4106381, 8212801, 16425623, 32851249, 65702503,
+    131405047, 262810099, 525620209};
+const int BUCKET_PRIME_COUNT = sizeof(BUCKET_PRIMES) / sizeof(BUCKET_PRIMES[0]);
+
+// 渐进式再散列: 每次增删最多迁移的旧桶/旧槽数
+const int REHASH_STEP = 16;
+
+// 批量查找时每批同时在途的键数(预取深度)
+const int BATCH_LOOKUP_WIDTH = 32;
+
+// ==================== 散列函数 ====================
+// 乘法散列, 丢弃低 16 位; 拉链法再对质数桶数取模
+template <typename Key>
+struct MultiplicativeHash
+{
+    unsigned long long operator()(const Key &key) const
+    {
+        return (HASH_MULTIPLIER * (unsigned long long)key) >> 16;
+    }
+};
+
+// 64 位黄金分割乘法后折叠高位, 使低位也充分混合;
+// 开放定址法用低 7 位作指纹、其余位选组, 需要这样的全字混合
+template <typename Key>
+struct FibonacciMixHash
+{
+    unsigned long long operator()(const Key &key) const
+    {
+        unsigned long long hash = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+        return hash ^ (hash >> 29);
+    }
+};
+
+// int 键先按无符号 32 位扩展, 负数键不会把高 32 位全部置 1
+template <>
+struct FibonacciMixHash<int>
+{
+    unsigned long long operator()(int key) const
+    {
+        unsigned long long hash = (unsigned long long)(unsigned int)key * 0x9E3779B97F4A7C15ULL;
+        return hash ^ (hash >> 29);
+    }
+};
+
+// ==================== 结点池 ====================
+// 以页为单位批量申请 Node, 同一页内的结点在内存中连续;
+// 删除的结点挂入空闲链表供下次插入复用, 清空时按页整体释放。
+// Node 须有名为 next 的指针成员。
+template <typename Node>
+class NodePool
+{
+public:
+    NodePool() : pages_(nullptr), used_in_page_(NODES_PER_PAGE), free_list_(nullptr) {}
+    ~NodePool() { ReleaseAll(); }
+
+    Node *Allocate();
+    void Free(Node *node);
+
+    // 释放全部页, 之前分配出去的结点全部失效
+    void ReleaseAll();
+
+private:
+    static const int NODES_PER_PAGE = 1024;
+
+    struct Page
+    {
+        Page *next;
+        Node nodes[NODES_PER_PAGE];
+    };
+
+    Page *pages_;       // 页链表, 表头为当前正在切分的页
+    int used_in_page_;  // 当前页已切出的结点数
+    Node *free_list_;   // 被删除结点组成的空闲链表(借用 next 指针)
+};
+
+template <typename Node>
+Node *NodePool<Node>::Allocate()
+{
+    Node *node;
+    if (free_list_ != nullptr)
+    {
+        node = free_list_;
+        free_list_ = free_list_->next;
+    }
+    else
+    {
+        if (used_in_page_ == NODES_PER_PAGE)
+        {
+            Page *page = new Page;
+            page->next = pages_;
+            pages_ = page;
+            used_in_page_ = 0;
+        }
+        node = &pages_->nodes[used_in_page_++];
+    }
+    node->next = nullptr;
+    return node;
+}
+
+template <typename Node>
+void NodePool<Node>::Free(Node *node)
+{
+    node->next = free_list_;
+    free_list_ = node;
+}
+
+template <typename Node>
+void NodePool<Node>::ReleaseAll()
+{
+    while (pages_ != nullptr)
+    {
+        Page *next = pages_->next;
+        delete pages_;
+        pages_ = next;
+    }
+    used_in_page_ = NODES_PER_PAGE;
+    free_list_ = nullptr;
+}
+
+// 哈希表运行状态
+struct TableStats
+{
+    int bucket_count;     // 当前桶数(开放定址为槽位数)
+    double load_factor;   // 装载因子
+    int max_chain_length; // 最长冲突链(开放定址为最长探测组数)
+    bool rehashing;       // 是否正在渐进式再散列
+};
+
+// ==================== 拉链法哈希表 ====================
+// 装载因子超过 1 时扩容、低于 1/8 时缩容; 扩缩容不一次性完成,
+// 而是保留旧桶数组, 在之后每次增删时迁移 REHASH_STEP 个旧桶,
+// 迁移期间查找同时检查新旧两张表。
+template <typename Key, typename Value, typename Hash>
+class ChainedHashTable
+{
+public:
+    ChainedHashTable();
+    ~ChainedHashTable();
+
+    // 按键查找, 未找到返回 nullptr
+    Value *Find(const Key &key);
+
+    // 插入(调用方保证键不存在)
+    void Insert(const Key &key, const Value &value);
+
+    // 按键删除, 成功时将被删除的值写入 removed(可为 nullptr)
+    bool Erase(const Key &key, Value *removed);
+
+    void Clear();
+
+    // 批量查找, results[i] 为 keys[i] 对应的值(不存在为 nullptr)
+    void FindBatch(const Key *keys, int n, Value **results);
+
+    int Size() const { return size_; }
+    TableStats Stats() const;
+
+    // 预留至少容纳 n 条记录的桶数, 避免批量导入时反复扩容
+    void Reserve(int n);
+
+    // 依次访问每条记录, visit(key, value)
+    template <typename Visitor>
+    void ForEach(Visitor &visit);
+
+    // 链长分布: histogram[k] 为链长为 k 的桶数, 链长不小于 max_length 的计入 histogram[max_length]
+    void ChainLengthHistogram(int *histogram, int max_length) const;
+
+private:
+    struct Node
+    {
+        Key key;
+        Value value;
+        Node *next;
+    };
+
+    Node **buckets_;            // 当前(新)桶数组
+    int bucket_count_;
+    int prime_level_;           // bucket_count_ 在 BUCKET_PRIMES 中的下标
+    Node **old_buckets_;        // 迁移中的旧桶数组, 无迁移时为 nullptr
+    int old_bucket_count_;
+    int migrate_pos_;           // 旧桶中下一个待迁移的下标
+    int size_;
+    NodePool<Node> pool_;       // 链表结点均从结点池分配
+
+    static int BucketOf(const Key &key, int bucket_count) { return Hash()(key) % bucket_count; }
+    static Node *FindInChain(Node *head, const Key &key);
+    bool EraseFromChain(Node **head, const Key &key, Value *removed);
+    static int ChainLength(const Node *head);
+
+    void BeginRehash(int new_level);
+    void RehashStep();
+    void FinishRehash();
+};
+
+template <typename Key, typename Value, typename Hash>
+template <typename Visitor>
+void ChainedHashTable<Key, Value, Hash>::ForEach(Visitor &visit)
+{
+    for (int i = 0; i < bucket_count_; ++i)
+    {
+        for (Node *current = buckets_[i]; current != nullptr; current = current->next)
+        {
+            visit(current->key, current->value);
+        }
+    }
+    for (int i = migrate_pos_; old_buckets_ != nullptr && i < old_bucket_count_; ++i)
+    {
+        for (Node *current = old_buckets_[i]; current != nullptr; current = current->next)
+        {
+            visit(current->key, current->value);
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+ChainedHashTable<Key, Value, Hash>::ChainedHashTable()
+    : bucket_count_(HASH_TABLE_SIZE), prime_level_(0),
+      old_buckets_(nullptr), old_bucket_count_(0), migrate_pos_(0), size_(0)
+{
+    buckets_ = new Node *[bucket_count_]();
+}
+
+template <typename Key, typename Value, typename Hash>
+ChainedHashTable<Key, Value, Hash>::~ChainedHashTable()
+{
+    delete[] buckets_;
+    delete[] old_buckets_;
+}
+
+template <typename Key, typename Value, typename Hash>
+typename ChainedHashTable<Key, Value, Hash>::Node *
+ChainedHashTable<Key, Value, Hash>::FindInChain(Node *head, const Key &key)
+{
+    while (head != nullptr)
+    {
+        if (head->key == key)
+        {
+            return head;
+        }
+        head = head->next;
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool ChainedHashTable<Key, Value, Hash>::EraseFromChain(Node **head, const Key &key, Value *removed)
+{
+    Node *current = *head;
+    Node *prev = nullptr;
+    while (current != nullptr)
+    {
+        if (current->key == key)
+        {
+            if (prev == nullptr)
+            {
+                *head = current->next;
+            }
+            else
+            {
+                prev->next = current->next;
+            }
+            if (removed != nullptr)
+            {
+                *removed = current->value;
+            }
+            pool_.Free(current);
+            return true;
+        }
+        prev = current;
+        current = current->next;
+    }
+    return false;
+}
+
+template <typename Key, typename Value, typename Hash>
+int ChainedHashTable<Key, Value, Hash>::ChainLength(const Node *head)
+{
+    int length = 0;
+    for (; head != nullptr; head = head->next)
+    {
+        length++;
+    }
+    return length;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value *ChainedHashTable<Key, Value, Hash>::Find(const Key &key)
+{
+    Node *node = FindInChain(buckets_[BucketOf(key, bucket_count_)], key);
+    if (node == nullptr && old_buckets_ != nullptr)
+    {
+        int index = BucketOf(key, old_bucket_count_);
+        if (index >= migrate_pos_)
+        {
+            node = FindInChain(old_buckets_[index], key);
+        }
+    }
+    return node != nullptr ? &node->value : nullptr;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::FindBatch(const Key *keys, int n, Value **results)
+{
+    // 分三轮流水处理一批键: 算散列并预取桶头 -> 读桶头并预取首结点 -> 沿链比对,
+    // 每轮的访存都在前一轮发出的预取之后, 同一批的缓存未命中得以重叠
+    int index[BATCH_LOOKUP_WIDTH];
+    Node *head[BATCH_LOOKUP_WIDTH];
+    for (int start = 0; start < n; start += BATCH_LOOKUP_WIDTH)
+    {
+        int count = n - start < BATCH_LOOKUP_WIDTH ? n - start : BATCH_LOOKUP_WIDTH;
+        for (int i = 0; i < count; ++i)
+        {
+            index[i] = BucketOf(keys[start + i], bucket_count_);
+            __builtin_prefetch(&buckets_[index[i]]);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            head[i] = buckets_[index[i]];
+            if (head[i] != nullptr)
+            {
+                // 结点可能跨两条缓存行: 键在头部, next 在尾部
+                __builtin_prefetch(&head[i]->key);
+                __builtin_prefetch(&head[i]->next);
+            }
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            Node *node = FindInChain(head[i], keys[start + i]);
+            if (node == nullptr && old_buckets_ != nullptr)
+            {
+                results[start + i] = Find(keys[start + i]);
+            }
+            else
+            {
+                results[start + i] = node != nullptr ? &node->value : nullptr;
+            }
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::Insert(const Key &key, const Value &value)
+{
+    if (old_buckets_ != nullptr)
+    {
+        RehashStep();
+    }
+    else if (size_ >= bucket_count_ && prime_level_ + 1 < BUCKET_PRIME_COUNT)
+    {
+        BeginRehash(prime_level_ + 1);
+    }
+
+    // 头插法(迁移期间总是插入新表)
+    Node *new_node = pool_.Allocate();
+    new_node->key = key;
+    new_node->value = value;
+
+    int index = BucketOf(key, bucket_count_);
+    new_node->next = buckets_[index];
+    buckets_[index] = new_node;
+    size_++;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool ChainedHashTable<Key, Value, Hash>::Erase(const Key &key, Value *removed)
+{
+    bool erased = EraseFromChain(&buckets_[BucketOf(key, bucket_count_)], key, removed);
+    if (!erased && old_buckets_ != nullptr)
+    {
+        int index = BucketOf(key, old_bucket_count_);
+        erased = index >= migrate_pos_ && EraseFromChain(&old_buckets_[index], key, removed);
+    }
+    if (!erased)
+    {
+        return false;
+    }
+
+    size_--;
+    if (old_buckets_ != nullptr)
+    {
+        RehashStep();
+    }
+    else if (prime_level_ > 0 && size_ * 8 < bucket_count_)
+    {
+        BeginRehash(prime_level_ - 1);
+    }
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::BeginRehash(int new_level)
+{
+    old_buckets_ = buckets_;
+    old_bucket_count_ = bucket_count_;
+    migrate_pos_ = 0;
+
+    prime_level_ = new_level;
+    bucket_count_ = BUCKET_PRIMES[new_level];
+    buckets_ = new Node *[bucket_count_]();
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::RehashStep()
+{
+    int end = migrate_pos_ + REHASH_STEP;
+    if (end > old_bucket_count_)
+    {
+        end = old_bucket_count_;
+    }
+
+    // 逐个摘下旧桶中的结点挂到新桶, 不重新分配结点
+    for (; migrate_pos_ < end; ++migrate_pos_)
+    {
+        Node *current = old_buckets_[migrate_pos_];
+        while (current != nullptr)
+        {
+            Node *next = current->next;
+            int index = BucketOf(current->key, bucket_count_);
+            current->next = buckets_[index];
+            buckets_[index] = current;
+            current = next;
+        }
+        old_buckets_[migrate_pos_] = nullptr;
+    }
+
+    if (migrate_pos_ == old_bucket_count_)
+    {
+        delete[] old_buckets_;
+        old_buckets_ = nullptr;
+        old_bucket_count_ = 0;
+        migrate_pos_ = 0;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::FinishRehash()
+{
+    while (old_buckets_ != nullptr)
+    {
+        RehashStep();
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::Reserve(int n)
+{
+    int level = prime_level_;
+    while (level + 1 < BUCKET_PRIME_COUNT && BUCKET_PRIMES[level] < n)
+    {
+        level++;
+    }
+    if (level == prime_level_)
+    {
+        return;
+    }
+
+    FinishRehash();
+    if (size_ == 0)
+    {
+        delete[] buckets_;
+        prime_level_ = level;
+        bucket_count_ = BUCKET_PRIMES[level];
+        buckets_ = new Node *[bucket_count_]();
+    }
+    else
+    {
+        BeginRehash(level);
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::Clear()
+{
+    // 结点全部归还结点池, 释放代价只与页数和桶数有关
+    pool_.ReleaseAll();
+    std::memset(buckets_, 0, sizeof(Node *) * bucket_count_);
+    delete[] old_buckets_;
+    old_buckets_ = nullptr;
+    old_bucket_count_ = 0;
+    migrate_pos_ = 0;
+    size_ = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ChainedHashTable<Key, Value, Hash>::ChainLengthHistogram(int *histogram, int max_length) const
+{
+    for (int k = 0; k <= max_length; ++k)
+    {
+        histogram[k] = 0;
+    }
+    for (int i = 0; i < bucket_count_; ++i)
+    {
+        int length = ChainLength(buckets_[i]);
+        histogram[length < max_length ? length : max_length]++;
+    }
+    for (int i = migrate_pos_; old_buckets_ != nullptr && i < old_bucket_count_; ++i)
+    {
+        int length = ChainLength(old_buckets_[i]);
+        histogram[length < max_length ? length : max_length]++;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+TableStats ChainedHashTable<Key, Value, Hash>::Stats() const
+{
+    TableStats stats;
+    stats.bucket_count = bucket_count_;
+    stats.load_factor = (double)size_ / bucket_count_;
+    stats.rehashing = old_buckets_ != nullptr;
+    stats.max_chain_length = 0;
+    for (int i = 0; i < bucket_count_; ++i)
+    {
+        int length = ChainLength(buckets_[i]);
+        if (length > stats.max_chain_length)
+        {
+            stats.max_chain_length = length;
+        }
+    }
+    for (int i = migrate_pos_; old_buckets_ != nullptr && i < old_bucket_count_; ++i)
+    {
+        int length = ChainLength(old_buckets_[i]);
+        if (length > stats.max_chain_length)
+        {
+            stats.max_chain_length = length;
+        }
+    }
+    return stats;
+}
+
+// ==================== 开放定址哈希表 ====================
+// 控制字节、键、值分三个数组存放:
+// 查找时先在 8 字节一组的控制字节里按 7 位指纹(H2)批量比对,
+// 命中后再核对稠密的键数组, 只有确认命中才会访问值,
+// 因此一次查找通常只涉及一到两条缓存行。
+// 扩缩容与拉链法一样是渐进式的: 旧数组保留到所有槽位迁移完毕。
+template <typename Key, typename Value, typename Hash>
+class OpenAddressingTable
+{
+public:
+    OpenAddressingTable();
+    ~OpenAddressingTable();
+
+    // 按键查找, 未找到返回 nullptr
+    Value *Find(const Key &key);
+
+    // 批量查找, results[i] 为 keys[i] 对应的值(不存在为 nullptr)
+    void FindBatch(const Key *keys, int n, Value **results);
+
+    // 插入(调用方保证键不存在)
+    void Insert(const Key &key, const Value &value);
+
+    // 按键删除, 成功时将被删除的值写入 removed(可为 nullptr)
+    bool Erase(const Key &key, Value *removed);
+
+    // 清空所有记录
+    void Clear();
+
+    int Size() const { return size_ + old_size_; }
+    TableStats Stats() const;
+
+    // 预留至少容纳 n 条记录的槽位, 避免批量导入时反复扩容
+    void Reserve(int n);
+
+    // 依次访问每条记录, visit(key, value)
+    template <typename Visitor>
+    void ForEach(Visitor &visit);
+
+private:
+    static const int GROUP_WIDTH = 8;               // 每组控制字节数
+    static const int MIN_CAPACITY = 16;             // 最小槽位数
+    static const unsigned char CTRL_EMPTY = 0x80;   // 空槽
+    static const unsigned char CTRL_DELETED = 0xFE; // 已删除(墓碑)
+
+    // 一组平行数组构成的一张表
+    struct Arrays
+    {
+        unsigned char *ctrl;  // 控制字节: 最高位为 0 时低 7 位保存 H2
+        Key *keys;            // 稠密键数组
+        Value *slots;         // 值数组
+        int capacity;         // 槽位数(2 的幂且不小于 MIN_CAPACITY)
+    };
+
+    Arrays table_;     // 当前(新)表
+    Arrays old_;       // 迁移中的旧表, 无迁移时 ctrl 为 nullptr
+    int size_;         // 新表中的记录数
+    int deleted_;      // 新表中的墓碑数
+    int old_size_;     // 旧表中尚未迁移的记录数
+    int migrate_pos_;  // 旧表中下一个待迁移的槽位
+
+    static unsigned long long LoadGroup(const unsigned char *ctrl);
+    static unsigned long long MatchByte(unsigned long long group, unsigned char h2);
+    static unsigned long long MatchEmpty(unsigned long long group);
+    static unsigned long long MatchEmptyOrDeleted(unsigned long long group);
+    static bool IsFull(unsigned char ctrl) { return (ctrl & 0x80) == 0; }
+
+    // 在一张表中查找, 返回槽位下标, 未找到返回 -1
+    static int FindSlot(const Arrays &arrays, const Key &key, unsigned long long hash);
+
+    // 在一张表中找到可写入的槽位(空槽或墓碑)
+    static int FindInsertSlot(const Arrays &arrays, unsigned long long hash);
+
+    // 删除一个槽位, 返回是否留下了墓碑
+    static bool EraseSlot(Arrays &arrays, int slot);
+
+    static Arrays Allocate(int capacity);
+    static void Release(Arrays &arrays);
+
+    void Place(const Key &key, const Value &value, unsigned long long hash);
+    void BeginRehash(int new_capacity);
+    void RehashStep(int max_slots);
+    void FinishRehash();
+};
+
+template <typename Key, typename Value, typename Hash>
+template <typename Visitor>
+void OpenAddressingTable<Key, Value, Hash>::ForEach(Visitor &visit)
+{
+    for (int i = 0; i < table_.capacity; ++i)
+    {
+        if (IsFull(table_.ctrl[i]))
+        {
+            visit(table_.keys[i], table_.slots[i]);
+        }
+    }
+    for (int i = migrate_pos_; old_.ctrl != nullptr && i < old_.capacity; ++i)
+    {
+        if (IsFull(old_.ctrl[i]))
+        {
+            visit(old_.keys[i], old_.slots[i]);
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+OpenAddressingTable<Key, Value, Hash>::OpenAddressingTable()
+    : size_(0), deleted_(0), old_size_(0), migrate_pos_(0)
+{
+    table_ = Allocate(MIN_CAPACITY);
+    old_.ctrl = nullptr;
+    old_.keys = nullptr;
+    old_.slots = nullptr;
+    old_.capacity = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+OpenAddressingTable<Key, Value, Hash>::~OpenAddressingTable()
+{
+    Release(table_);
+    Release(old_);
+}
+
+template <typename Key, typename Value, typename Hash>
+typename OpenAddressingTable<Key, Value, Hash>::Arrays
+OpenAddressingTable<Key, Value, Hash>::Allocate(int capacity)
+{
+    Arrays arrays;
+    arrays.capacity = capacity;
+    arrays.ctrl = new unsigned char[capacity];
+    arrays.keys = new Key[capacity];
+    arrays.slots = new Value[capacity];
+    std::memset(arrays.ctrl, CTRL_EMPTY, capacity);
+    return arrays;
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::Release(Arrays &arrays)
+{
+    delete[] arrays.ctrl;
+    delete[] arrays.keys;
+    delete[] arrays.slots;
+    arrays.ctrl = nullptr;
+    arrays.keys = nullptr;
+    arrays.slots = nullptr;
+    arrays.capacity = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+unsigned long long OpenAddressingTable<Key, Value, Hash>::LoadGroup(const unsigned char *ctrl)
+{
+    unsigned long long group;
+    std::memcpy(&group, ctrl, sizeof(group));
+    return group;
+}
+
+template <typename Key, typename Value, typename Hash>
+unsigned long long OpenAddressingTable<Key, Value, Hash>::MatchByte(unsigned long long group, unsigned char h2)
+{
+    // 经典"字中找零字节"技巧, 可能有假阳性, 由后续比对键排除
+    const unsigned long long lsbs = 0x0101010101010101ULL;
+    unsigned long long x = group ^ (lsbs * h2);
+    return (x - lsbs) & ~x & 0x8080808080808080ULL;
+}
+
+template <typename Key, typename Value, typename Hash>
+unsigned long long OpenAddressingTable<Key, Value, Hash>::MatchEmpty(unsigned long long group)
+{
+    // 空槽 0x80 的第 1 位为 0, 墓碑 0xFE 的第 1 位为 1
+    return group & (~group << 6) & 0x8080808080808080ULL;
+}
+
+template <typename Key, typename Value, typename Hash>
+unsigned long long OpenAddressingTable<Key, Value, Hash>::MatchEmptyOrDeleted(unsigned long long group)
+{
+    return group & 0x8080808080808080ULL;
+}
+
+template <typename Key, typename Value, typename Hash>
+int OpenAddressingTable<Key, Value, Hash>::FindSlot(const Arrays &arrays, const Key &key,
+                                                     unsigned long long hash)
+{
+    unsigned char h2 = hash & 0x7F;
+    int group_mask = arrays.capacity / GROUP_WIDTH - 1;
+    int group_index = (hash >> 7) & group_mask;
+
+    // 以组为单位做三角数探测, 组数为 2 的幂时可遍历所有组
+    for (int step = 1;; ++step)
+    {
+        int base = group_index * GROUP_WIDTH;
+        unsigned long long group = LoadGroup(arrays.ctrl + base);
+        unsigned long long match = MatchByte(group, h2);
+        while (match != 0)
+        {
+            int slot = base + __builtin_ctzll(match) / 8;
+            if (IsFull(arrays.ctrl[slot]) && arrays.keys[slot] == key)
+            {
+                return slot;
+            }
+            match &= match - 1;
+        }
+        if (MatchEmpty(group) != 0)
+        {
+            return -1;
+        }
+        group_index = (group_index + step) & group_mask;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+int OpenAddressingTable<Key, Value, Hash>::FindInsertSlot(const Arrays &arrays, unsigned long long hash)
+{
+    int group_mask = arrays.capacity / GROUP_WIDTH - 1;
+    int group_index = (hash >> 7) & group_mask;
+
+    for (int step = 1;; ++step)
+    {
+        int base = group_index * GROUP_WIDTH;
+        unsigned long long match = MatchEmptyOrDeleted(LoadGroup(arrays.ctrl + base));
+        if (match != 0)
+        {
+            return base + __builtin_ctzll(match) / 8;
+        }
+        group_index = (group_index + step) & group_mask;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+bool OpenAddressingTable<Key, Value, Hash>::EraseSlot(Arrays &arrays, int slot)
+{
+    // 所在组仍有空槽时, 探测链不会越过该组, 可直接置空而不留墓碑
+    int base = slot - slot % GROUP_WIDTH;
+    if (MatchEmpty(LoadGroup(arrays.ctrl + base)) != 0)
+    {
+        arrays.ctrl[slot] = CTRL_EMPTY;
+        return false;
+    }
+    arrays.ctrl[slot] = CTRL_DELETED;
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value *OpenAddressingTable<Key, Value, Hash>::Find(const Key &key)
+{
+    unsigned long long hash = Hash()(key);
+    int slot = FindSlot(table_, key, hash);
+    if (slot >= 0)
+    {
+        return &table_.slots[slot];
+    }
+    if (old_.ctrl != nullptr)
+    {
+        slot = FindSlot(old_, key, hash);
+        if (slot >= 0)
+        {
+            return &old_.slots[slot];
+        }
+    }
+    return nullptr;
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::FindBatch(const Key *keys, int n, Value **results)
+{
+    // 先为整批键算散列并预取各自首个探测组的控制字节与键, 再逐个比对
+    unsigned long long hash[BATCH_LOOKUP_WIDTH];
+    int group_mask = table_.capacity / GROUP_WIDTH - 1;
+    for (int start = 0; start < n; start += BATCH_LOOKUP_WIDTH)
+    {
+        int count = n - start < BATCH_LOOKUP_WIDTH ? n - start : BATCH_LOOKUP_WIDTH;
+        for (int i = 0; i < count; ++i)
+        {
+            hash[i] = Hash()(keys[start + i]);
+            int base = ((hash[i] >> 7) & group_mask) * GROUP_WIDTH;
+            __builtin_prefetch(table_.ctrl + base);
+            __builtin_prefetch(table_.keys + base);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            int slot = FindSlot(table_, keys[start + i], hash[i]);
+            if (slot >= 0)
+            {
+                results[start + i] = &table_.slots[slot];
+            }
+            else if (old_.ctrl != nullptr && (slot = FindSlot(old_, keys[start + i], hash[i])) >= 0)
+            {
+                results[start + i] = &old_.slots[slot];
+            }
+            else
+            {
+                results[start + i] = nullptr;
+            }
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::Place(const Key &key, const Value &value,
+                                                  unsigned long long hash)
+{
+    int slot = FindInsertSlot(table_, hash);
+    if (table_.ctrl[slot] == CTRL_DELETED)
+    {
+        deleted_--;
+    }
+    table_.ctrl[slot] = hash & 0x7F;
+    table_.keys[slot] = key;
+    table_.slots[slot] = value;
+    size_++;
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::Insert(const Key &key, const Value &value)
+{
+    if (old_.ctrl != nullptr)
+    {
+        RehashStep(REHASH_STEP);
+    }
+
+    // 装载因子(含墓碑)不超过 7/8
+    if ((size_ + deleted_ + 1) * 8 > table_.capacity * 7)
+    {
+        // 上一轮迁移尚未完成时先收尾, 保证同一时刻最多两张表
+        FinishRehash();
+        // 墓碑较多时按原容量整理, 否则扩容一倍
+        BeginRehash(size_ * 2 >= table_.capacity ? table_.capacity * 2 : table_.capacity);
+        RehashStep(REHASH_STEP);
+    }
+
+    Place(key, value, Hash()(key));
+}
+
+template <typename Key, typename Value, typename Hash>
+bool OpenAddressingTable<Key, Value, Hash>::Erase(const Key &key, Value *removed)
+{
+    unsigned long long hash = Hash()(key);
+    int slot = FindSlot(table_, key, hash);
+    if (slot >= 0)
+    {
+        if (removed != nullptr)
+        {
+            *removed = table_.slots[slot];
+        }
+        if (EraseSlot(table_, slot))
+        {
+            deleted_++;
+        }
+        size_--;
+    }
+    else if (old_.ctrl != nullptr && (slot = FindSlot(old_, key, hash)) >= 0)
+    {
+        if (removed != nullptr)
+        {
+            *removed = old_.slots[slot];
+        }
+        EraseSlot(old_, slot);
+        old_size_--;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (old_.ctrl != nullptr)
+    {
+        RehashStep(REHASH_STEP);
+    }
+    else if (table_.capacity > MIN_CAPACITY && size_ * 8 < table_.capacity)
+    {
+        BeginRehash(table_.capacity / 2);
+    }
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::BeginRehash(int new_capacity)
+{
+    old_ = table_;
+    old_size_ = size_;
+    migrate_pos_ = 0;
+
+    table_ = Allocate(new_capacity);
+    size_ = 0;
+    deleted_ = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::RehashStep(int max_slots)
+{
+    if (old_.ctrl == nullptr)
+    {
+        return;
+    }
+
+    int end = migrate_pos_ + max_slots;
+    if (end > old_.capacity)
+    {
+        end = old_.capacity;
+    }
+    for (; migrate_pos_ < end; ++migrate_pos_)
+    {
+        if (IsFull(old_.ctrl[migrate_pos_]))
+        {
+            Place(old_.keys[migrate_pos_], old_.slots[migrate_pos_], Hash()(old_.keys[migrate_pos_]));
+            // 旧槽留下墓碑, 既不会被再次查到, 也不截断其他键的探测链
+            old_.ctrl[migrate_pos_] = CTRL_DELETED;
+            old_size_--;
+        }
+    }
+
+    if (migrate_pos_ == old_.capacity)
+    {
+        Release(old_);
+        old_size_ = 0;
+        migrate_pos_ = 0;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::FinishRehash()
+{
+    RehashStep(old_.capacity);
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::Reserve(int n)
+{
+    int capacity = table_.capacity;
+    while ((long long)n * 8 > (long long)capacity * 7)
+    {
+        capacity *= 2;
+    }
+    if (capacity == table_.capacity)
+    {
+        return;
+    }
+
+    FinishRehash();
+    if (size_ == 0)
+    {
+        Release(table_);
+        table_ = Allocate(capacity);
+        deleted_ = 0;
+    }
+    else
+    {
+        BeginRehash(capacity);
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+void OpenAddressingTable<Key, Value, Hash>::Clear()
+{
+    Release(old_);
+    old_size_ = 0;
+    migrate_pos_ = 0;
+    std::memset(table_.ctrl, CTRL_EMPTY, table_.capacity);
+    size_ = 0;
+    deleted_ = 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+TableStats OpenAddressingTable<Key, Value, Hash>::Stats() const
+{
+    TableStats stats;
+    stats.bucket_count = table_.capacity;
+    stats.load_factor = (double)Size() / table_.capacity;
+    stats.rehashing = old_.ctrl != nullptr;
+    stats.max_chain_length = 0;
+
+    // 重新走一遍探测序列, 统计每个键到达所在组需要探测的组数
+    int group_mask = table_.capacity / GROUP_WIDTH - 1;
+    for (int i = 0; i < table_.capacity; ++i)
+    {
+        if (!IsFull(table_.ctrl[i]))
+        {
+            continue;
+        }
+        int group_index = (Hash()(table_.keys[i]) >> 7) & group_mask;
+        int probes = 1;
+        for (int step = 1; group_index != i / GROUP_WIDTH; ++step, ++probes)
+        {
+            group_index = (group_index + step) & group_mask;
+        }
+        if (probes > stats.max_chain_length)
+        {
+            stats.max_chain_length = probes;
+        }
+    }
+    return stats;
+}
+
+// ==================== 冲突处理策略 ====================
+// 策略类只负责把 (Key, Value, Hash) 映射到具体的表模板
+struct ChainingPolicy
+{
+    template <typename Key, typename Value, typename Hash>
+    struct Table
+    {
+        typedef ChainedHashTable<Key, Value, Hash> Type;
+    };
+};
+
+struct OpenAddressingPolicy
+{
+    template <typename Key, typename Value, typename Hash>
+    struct Table
+    {
+        typedef OpenAddressingTable<Key, Value, Hash> Type;
+    };
+};
+
+// ==================== 通用哈希表 ====================
+// 接口即所选策略的表接口: Find/FindBatch/Insert/Erase/Clear/Size/Stats/Reserve/ForEach,
+// 拉链法另有 ChainLengthHistogram。
+template <typename Key, typename Value,
+          typename Hash = FibonacciMixHash<Key>,
+          typename Policy = OpenAddressingPolicy>
+class HashMap : public Policy::template Table<Key, Value, Hash>::Type
+{
+};
+
+#endif
@@ -1,722 +1,4886 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <cstdio>       // rename
+#include <cerrno>
+#include <fcntl.h>      // 快照、日志与批处理文件的读写
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>    // 仅并发版本与并发压测使用
+#include "hash_map.h"   // 通用哈希表模板(拉链法/开放定址法)
 
-// ==================== 考生信息结构体 ====================
-struct Student
+// 新建快照与日志文件的权限
+const int FILE_MODE = 0644;
+
+// ==================== 只读内存映射文件 ====================
+class MappedFile
 {
-    int exam_id;       // 准考证号
-    char name[50];     // 姓名
-    char gender[10];   // 性别
-    int age;           // 年龄
-    char category[50]; // 报考类别
-};
+public:
+    MappedFile() : data_(nullptr), size_(0), buffered_(false) {}
+    ~MappedFile() { Close(); }
 
-// A prime number for the hash table size
-const int HASH_TABLE_SIZE = 997;
+    // 映射整个文件, 失败返回 false(空文件映射成功但 Data() 为 nullptr);
+    // 路径为 "-" 时读标准输入, 管道等无法映射的输入改为整体读入内存
+    bool Open(const char *path);
+    void Close();
 
-// ==================== 链表节点 ====================
-struct Node
-{
-    Student data;
-    Node *next;
+    const char *Data() const { return data_; }
+    long Size() const { return size_; }
+
+private:
+    const char *data_;
+    long size_;
+    bool buffered_; // data_ 为 new[] 分配的读入缓冲而非映射
 
-    Node() : next(nullptr) {}
+    bool ReadStream(int fd);
 };
-// ==================== 考生管理系统类 ====================
-class ExamRegistrationSystem
+
+// 当前墙上时间(微秒)
+static long long NowMicros()
 {
-public:
-    ExamRegistrationSystem();
-    ~ExamRegistrationSystem();
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
 
-    // 初始化系统
-    void Initialize();
+// 写满整个缓冲区, 失败返回 false
+static bool WriteAll(int fd, const void *buf, long size)
+{
+    const char *p = (const char *)buf;
+    while (size > 0)
+    {
+        long written = write(fd, p, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+        p += written;
+        size -= written;
+    }
+    return true;
+}
 
-    // 插入考生
-    void Insert();
+bool MappedFile::Open(const char *path)
+{
+    Close();
+    if (std::strcmp(path, "-") == 0)
+    {
+        return ReadStream(STDIN_FILENO);
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
 
-    // 删除考生
-    void Delete();
+    long size = lseek(fd, 0, SEEK_END);
+    if (size < 0)
+    {
+        bool ok = ReadStream(fd);
+        close(fd);
+        return ok;
+    }
+    if (size > 0)
+    {
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        data_ = (const char *)addr;
+    }
+    size_ = size;
+    close(fd); // 映射建立后即可关闭描述符
+    return true;
+}
 
-    // 查找考生
-    void Search();
+bool MappedFile::ReadStream(int fd)
+{
+    long capacity = 1 << 16;
+    char *data = new char[capacity];
+    long size = 0;
+    while (true)
+    {
+        if (size == capacity)
+        {
+            char *grown = new char[capacity * 2];
+            std::memcpy(grown, data, size);
+            delete[] data;
+            data = grown;
+            capacity *= 2;
+        }
+        long got = read(fd, data + size, capacity - size);
+        if (got < 0)
+        {
+            delete[] data;
+            return false;
+        }
+        if (got == 0)
+        {
+            break;
+        }
+        size += got;
+    }
+    data_ = data;
+    size_ = size;
+    buffered_ = true;
+    return true;
+}
 
-    // 修改考生信息
-    void Modify();
+void MappedFile::Close()
+{
+    if (buffered_)
+    {
+        delete[] data_;
+    }
+    else if (data_ != nullptr)
+    {
+        munmap((void *)data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    buffered_ = false;
+}
 
-    // 统计考生信息
-    void Statistics();
+// ==================== 输出缓冲 ====================
+// 攒满一块再用一次 write 写出, 批处理模式下不逐行刷新
+class OutputBuffer
+{
+public:
+    explicit OutputBuffer(int fd) : fd_(fd), size_(0) {}
+    ~OutputBuffer() { Flush(); }
 
-    // 运行系统
-    void Run();
+    void Append(const char *text, int length);
+    void Append(const char *text) { Append(text, std::strlen(text)); }
+    void Append(char ch);
+    void AppendInt(long long value);
+    void Flush();
 
 private:
-    Node *table_[HASH_TABLE_SIZE]; // 哈希表
-    int count_;                    // 考生数量
+    static const int CAPACITY = 1 << 16;
 
-    // 哈希函数
-    int Hash(int exam_id);
+    int fd_;
+    int size_;
+    char data_[CAPACITY];
+};
 
-    // 输出所有考生信息
-    void PrintAll();
+void OutputBuffer::Append(const char *text, int length)
+{
+    if (size_ + length > CAPACITY)
+    {
+        Flush();
+        if (length > CAPACITY)
+        {
+            WriteAll(fd_, text, length);
+            return;
+        }
+    }
+    std::memcpy(data_ + size_, text, length);
+    size_ += length;
+}
 
-    // 输出表头
-    void PrintHeader();
+void OutputBuffer::Append(char ch)
+{
+    if (size_ == CAPACITY)
+    {
+        Flush();
+    }
+    data_[size_++] = ch;
+}
 
-    // 输出单个考生信息
-    void PrintStudent(const Student &stu);
+void OutputBuffer::AppendInt(long long value)
+{
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = value < 0 ? -(unsigned long long)value : value;
+    do
+    {
+        digits[sizeof(digits) - 1 - length++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+    {
+        digits[sizeof(digits) - 1 - length++] = '-';
+    }
+    Append(digits + sizeof(digits) - length, length);
+}
 
-    // 清空链表
-    void Clear();
+void OutputBuffer::Flush()
+{
+    if (size_ > 0)
+    {
+        WriteAll(fd_, data_, size_);
+        size_ = 0;
+    }
+}
 
-    // 按考号查找节点
-    Node *FindByExamId(int exam_id);
+// ==================== 考生信息结构体 ====================
+struct Student
+{
+    int exam_id;       // 准考证号
+    char name[50];     // 姓名
+    char gender[10];   // 性别
+    int age;           // 年龄
+    char category[50]; // 报考类别
+};
 
-    // 按考号删除
-    bool DeleteByExamId(int exam_id);
+// 考号上限
+const int MAX_EXAM_ID = 999999;
 
-    // 检查考号是否存在
-    bool ExamIdExists(int exam_id);
+// 合法年龄范围
+const int MIN_AGE = 10;
+const int MAX_AGE = 100;
 
-    // 输入考生信息(带合法性检查)
-    bool InputStudent(Student &stu, bool check_duplicate = true);
+// ==================== 紧凑考生记录 ====================
+// 哈希表中实际保存的记录。性别只有两种取值, 存一个字节;
+// 报考类别种类很少, 存类别字典中的编号; 姓名存入姓名区, 只保留偏移。
+// 每条 12 字节, 而 Student 约 120 字节, 扫描全表时能装进缓存的记录多出数倍。
+// Student 仍用于输入、预写日志和快照等需要自包含记录的场合。
+enum Gender
+{
+    GENDER_MALE = 0,  // 男
+    GENDER_FEMALE = 1 // 女
+};
 
-    // 验证性别输入
-    bool ValidateGender(const char *gender);
+struct StudentRecord
+{
+    int exam_id;              // 准考证号
+    unsigned int name_offset; // 姓名在姓名区中的偏移
+    unsigned short category;  // 报考类别在类别字典中的编号
+    unsigned char gender;     // Gender
+    unsigned char age;        // 年龄
+};
 
-    // 验证年龄输入
-    bool ValidateAge(int age);
+// 姓名区待回收字节数的下限, 低于此值不压缩
+const long NAME_GARBAGE_LIMIT = 65536;
 
-    // 验证考号输入
-    bool ValidateExamId(int exam_id);
+// ==================== 字符串区 ====================
+// 字符串以 '\0' 结尾依次追加在一块连续内存中, 用偏移引用(扩容后偏移不变)。
+// 不再使用的字符串只计入垃圾字节数, 由调用方在垃圾过多时整体重建。
+class NameArena
+{
+public:
+    NameArena() : data_(nullptr), size_(0), capacity_(0), garbage_(0) {}
+    ~NameArena() { delete[] data_; }
 
-    // 清空输入缓冲区
-    void ClearInputBuffer();
+    // 追加字符串, 返回其偏移
+    unsigned int Add(const char *text);
 
-    // 打印分割线
-    void PrintSeparator(char ch = '=', int length = 70);
+    // 标记偏移处的字符串已不再使用
+    void Release(unsigned int offset) { garbage_ += std::strlen(data_ + offset) + 1; }
 
-    // 打印标题
-    void PrintTitle(const char *title);
+    const char *Get(unsigned int offset) const { return data_ + offset; }
+    long Size() const { return size_; }
+    long GarbageBytes() const { return garbage_; }
 
-    // 显示主菜单
-    void ShowMenu();
+    void Reserve(long capacity);
+    void Swap(NameArena &other);
+    void Clear();
+
+private:
+    char *data_;
+    long size_;
+    long capacity_;
+    long garbage_; // 已释放字符串占用的字节数
 };
 
-// ==================== 构造函数和析构函数 ====================
-ExamRegistrationSystem::ExamRegistrationSystem() : count_(0)
+unsigned int NameArena::Add(const char *text)
 {
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i)
+    long length = std::strlen(text) + 1;
+    if (size_ + length > capacity_)
     {
-        table_[i] = nullptr;
+        long capacity = capacity_ > 0 ? capacity_ * 2 : 4096;
+        Reserve(capacity > size_ + length ? capacity : size_ + length);
     }
+    unsigned int offset = size_;
+    std::memcpy(data_ + size_, text, length);
+    size_ += length;
+    return offset;
 }
 
-ExamRegistrationSystem::~ExamRegistrationSystem()
+void NameArena::Reserve(long capacity)
 {
-    Clear();
+    if (capacity <= capacity_)
+    {
+        return;
+    }
+    char *data = new char[capacity];
+    if (size_ > 0)
+    {
+        std::memcpy(data, data_, size_);
+    }
+    delete[] data_;
+    data_ = data;
+    capacity_ = capacity;
 }
 
-// ==================== 辅助函数 ====================
-int ExamRegistrationSystem::Hash(int exam_id)
+void NameArena::Swap(NameArena &other)
 {
-    // A is a prime number close to the golden ratio conjugate
-    const unsigned long long A = 2654435769;
-    unsigned long long hash = A * exam_id;
-    return (hash >> 16) % HASH_TABLE_SIZE;
+    char *data = data_;
+    long size = size_;
+    long capacity = capacity_;
+    long garbage = garbage_;
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    garbage_ = other.garbage_;
+    other.data_ = data;
+    other.size_ = size;
+    other.capacity_ = capacity;
+    other.garbage_ = garbage;
 }
 
-void ExamRegistrationSystem::Clear()
+void NameArena::Clear()
 {
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i)
-    {
-        Node *current = table_[i];
-        while (current != nullptr)
-        {
-            Node *temp = current;
-            current = current->next;
-            delete temp;
-        }
-        table_[i] = nullptr;
-    }
-    count_ = 0;
+    delete[] data_;
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    garbage_ = 0;
 }
 
-void ExamRegistrationSystem::ClearInputBuffer()
+// ==================== 报考类别字典 ====================
+// 把类别名映射为从 0 开始的连续编号, 编号一经分配不再回收。
+// 名称存放在字符串区, 编号 -> 名称查数组, 名称 -> 编号查开放定址表。
+class CategoryDictionary
 {
-    std::cin.clear();
-    std::cin.ignore(10000, '\n');
-}
+public:
+    CategoryDictionary()
+        : offsets_(nullptr), count_(0), capacity_(0), slots_(nullptr), slot_count_(0) {}
+    ~CategoryDictionary() { Clear(); }
 
-void ExamRegistrationSystem::PrintSeparator(char ch, int length)
+    // 编号存为 unsigned short, 类别种数不能超过该值
+    static const int MAX_CATEGORIES = 65535;
+
+    // 返回类别编号, 不存在时登记为新类别; 类别已满时返回 -1
+    int Intern(const char *category);
+
+    // 返回类别编号, 不存在时返回 -1
+    int Find(const char *category) const;
+
+    const char *Name(int id) const { return text_.Get(offsets_[id]); }
+    int Size() const { return count_; }
+    void Clear();
+
+private:
+    NameArena text_;         // 类别名
+    unsigned int *offsets_;  // 编号 -> 类别名偏移
+    int count_;
+    int capacity_;
+    int *slots_;             // 开放定址表, 保存编号, -1 为空; 槽数为容量的 2 倍
+    int slot_count_;
+
+    static unsigned int Hash(const char *category);
+    int FindSlot(const char *category, unsigned int hash) const;
+    void Grow();
+};
+
+unsigned int CategoryDictionary::Hash(const char *category)
 {
-    for (int i = 0; i < length; ++i)
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)category; *p != '\0'; ++p)
     {
-        std::cout << ch;
+        hash = (hash ^ *p) * 16777619u;
     }
-    std::cout << std::endl;
+    return hash;
 }
 
-void ExamRegistrationSystem::PrintTitle(const char *title)
+int CategoryDictionary::FindSlot(const char *category, unsigned int hash) const
 {
-    PrintSeparator('=');
-    int title_len = std::strlen(title);
-    int padding = (70 - title_len) / 2;
-    for (int i = 0; i < padding; ++i)
+    int mask = slot_count_ - 1;
+    int slot = hash & mask;
+    while (slots_[slot] >= 0 && std::strcmp(Name(slots_[slot]), category) != 0)
     {
-        std::cout << " ";
+        slot = (slot + 1) & mask;
     }
-    std::cout << title << std::endl;
-    PrintSeparator('=');
-}
-
-void ExamRegistrationSystem::ShowMenu()
-{
-    std::cout << std::endl;
-    PrintSeparator('-');
-    std::cout << "  [1] 插入考生信息" << std::endl;
-    std::cout << "  [2] 删除考生信息" << std::endl;
-    std::cout << "  [3] 查找考生信息" << std::endl;
-    std::cout << "  [4] 修改考生信息" << std::endl;
-    std::cout << "  [5] 统计考生信息" << std::endl;
-    std::cout << "  [0] 退出系统   " << std::endl;
-    PrintSeparator('-');
+    return slot;
 }
 
-void ExamRegistrationSystem::PrintHeader()
+int CategoryDictionary::Find(const char *category) const
 {
-    PrintSeparator('-');
-    std::cout << "考号\t姓名\t\t性别\t年龄\t报考类别" << std::endl;
-    PrintSeparator('-');
+    if (count_ == 0)
+    {
+        return -1;
+    }
+    return slots_[FindSlot(category, Hash(category))];
 }
 
-void ExamRegistrationSystem::PrintStudent(const Student &stu)
+int CategoryDictionary::Intern(const char *category)
 {
-    std::cout << stu.exam_id << "\t";
-
-    // 姓名对齐处理
-    int name_len = std::strlen(stu.name);
-    std::cout << stu.name;
-    if (name_len < 8)
+    if (count_ == capacity_)
     {
-        std::cout << "\t";
+        if (count_ == MAX_CATEGORIES)
+        {
+            return Find(category);
+        }
+        Grow();
     }
-    std::cout << "\t";
-
-    std::cout << stu.gender << "\t"
-              << stu.age << "\t"
-              << stu.category << std::endl;
+    int slot = FindSlot(category, Hash(category));
+    if (slots_[slot] < 0)
+    {
+        offsets_[count_] = text_.Add(category);
+        slots_[slot] = count_++;
+    }
+    return slots_[slot];
 }
 
-void ExamRegistrationSystem::PrintAll()
+void CategoryDictionary::Grow()
 {
-    if (count_ == 0)
+    int capacity = capacity_ > 0 ? capacity_ * 2 : 16;
+    if (capacity > MAX_CATEGORIES)
     {
-        std::cout << "\n*** 当前系统中暂无考生信息! ***\n"
-                  << std::endl;
-        return;
+        capacity = MAX_CATEGORIES;
+    }
+    unsigned int *offsets = new unsigned int[capacity];
+    for (int i = 0; i < count_; ++i)
+    {
+        offsets[i] = offsets_[i];
     }
+    delete[] offsets_;
+    offsets_ = offsets;
+    capacity_ = capacity;
 
-    std::cout << std::endl;
-    PrintHeader();
-    for (int i = 0; i < HASH_TABLE_SIZE; ++i)
+    delete[] slots_;
+    slot_count_ = 1;
+    while (slot_count_ < capacity * 2)
     {
-        Node *current = table_[i];
-        while (current != nullptr)
-        {
-            PrintStudent(current->data);
-            current = current->next;
-        }
+        slot_count_ *= 2;
+    }
+    slots_ = new int[slot_count_];
+    for (int i = 0; i < slot_count_; ++i)
+    {
+        slots_[i] = -1;
+    }
+    for (int id = 0; id < count_; ++id)
+    {
+        slots_[FindSlot(Name(id), Hash(Name(id)))] = id;
     }
-    PrintSeparator('-');
-    std::cout << "总计: " << count_ << " 名考生" << std::endl;
 }
 
-// ==================== 验证函数 ====================
-bool ExamRegistrationSystem::ValidateGender(const char *gender)
+void CategoryDictionary::Clear()
 {
-    return (std::strcmp(gender, "男") == 0 || std::strcmp(gender, "女") == 0);
+    text_.Clear();
+    delete[] offsets_;
+    delete[] slots_;
+    offsets_ = nullptr;
+    slots_ = nullptr;
+    count_ = 0;
+    capacity_ = 0;
+    slot_count_ = 0;
 }
 
-bool ExamRegistrationSystem::ValidateAge(int age)
+// ==================== 校验和 ====================
+const unsigned int FNV_OFFSET_BASIS = 2166136261u;
+
+// FNV-1a, 可分段累加: hash 传入前一段的结果, 首段传 FNV_OFFSET_BASIS
+static unsigned int Fnv1a(unsigned int hash, const void *data, long size)
 {
-    return (age >= 10 && age <= 100);
+    const unsigned char *p = (const unsigned char *)data;
+    for (long i = 0; i < size; ++i)
+    {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
 }
 
-bool ExamRegistrationSystem::ValidateExamId(int exam_id)
+// ==================== 快照文件格式 ====================
+// 文件头后紧跟 count 条定长 Student 记录, 按内存布局原样写出,
+// 载入时直接映射文件, 整体校验后逐条插入, 不做任何文本解析(仅用于同一平台)。
+const char SNAPSHOT_MAGIC[8] = {'P', '1', 'S', 'N', 'A', 'P', '0', '2'};
+
+struct SnapshotHeader
 {
-    return (exam_id > 0 && exam_id < 1000000);
-}
+    char magic[8];                    // SNAPSHOT_MAGIC
+    int record_size;                  // sizeof(Student), 用于校验布局
+    int count;                        // 记录数
+    unsigned int checksum;            // 记录区的 FNV-1a 校验和
+    int engine;                       // 保存时的存储引擎
+    int bucket_count;                 // 保存时的桶数(开放定址为槽位数)
+    unsigned long long hash_multiplier; // 保存时的散列常数
+};
 
-bool ExamRegistrationSystem::ExamIdExists(int exam_id)
+// ==================== 存储引擎 ====================
+enum StorageEngine
 {
-    return FindByExamId(exam_id) != nullptr;
-}
+    CHAINING_ENGINE,        // 拉链法(默认)
+    OPEN_ADDRESSING_ENGINE  // 开放定址法(SwissTable 风格控制字节)
+};
 
-bool ExamRegistrationSystem::InputStudent(Student &stu, bool check_duplicate)
+// 两种存储引擎对应的哈希表: 键为考号, 值为紧凑记录
+typedef HashMap<int, StudentRecord, MultiplicativeHash<int>, ChainingPolicy> ChainedRecordTable;
+typedef HashMap<int, StudentRecord, FibonacciMixHash<int>, OpenAddressingPolicy> OpenRecordTable;
+
+// ==================== 考号集合 ====================
+// 线性探测的整数集合, 供二级索引保存考号; 0 表示空槽(考号从 1 开始)
+class IdSet
 {
-    // 输入考号
-    while (true)
-    {
-        std::cout << "考号: ";
-        if (!(std::cin >> stu.exam_id))
-        {
-            std::cout << "*** 错误: 考号必须是数字! 请重新输入。***" << std::endl;
-            ClearInputBuffer();
-            continue;
-        }
+public:
+    IdSet() : slots_(nullptr), capacity_(0), size_(0) {}
+    ~IdSet() { delete[] slots_; }
 
-        if (!ValidateExamId(stu.exam_id))
-        {
-            std::cout << "*** 错误: 考号必须在 1-999999 之间! ***" << std::endl;
-            continue;
-        }
+    void Add(int id);
+    bool Remove(int id);
+    void Clear();
+    int Size() const { return size_; }
 
-        if (check_duplicate && ExamIdExists(stu.exam_id))
-        {
-            std::cout << "*** 错误: 考号 " << stu.exam_id << " 已存在! 请使用其他考号。***" << std::endl;
-            continue;
-        }
+    template <typename Visitor>
+    void ForEach(Visitor &visit) const;
 
-        break;
-    }
+private:
+    int *slots_;
+    int capacity_; // 0 或 2 的幂
+    int size_;
 
-    // 输入姓名
-    while (true)
+    int Home(int id) const
     {
-        std::cout << "姓名: ";
-        std::cin >> stu.name;
+        unsigned int hash = (unsigned int)id * 2654435769u;
+        return (hash ^ (hash >> 16)) & (capacity_ - 1);
+    }
+    void Resize(int capacity);
+};
 
-        int name_len = std::strlen(stu.name);
-        if (name_len == 0 || name_len >= 50)
+template <typename Visitor>
+void IdSet::ForEach(Visitor &visit) const
+{
+    for (int i = 0; i < capacity_; ++i)
+    {
+        if (slots_[i] != 0)
         {
-            std::cout << "*** 错误: 姓名长度必须在 1-49 个字符之间! ***" << std::endl;
-            continue;
+            visit(slots_[i]);
         }
-
-        break;
     }
+}
 
-    // 输入性别
-    while (true)
+void IdSet::Resize(int capacity)
+{
+    int *old_slots = slots_;
+    int old_capacity = capacity_;
+    slots_ = capacity > 0 ? new int[capacity]() : nullptr;
+    capacity_ = capacity;
+    for (int i = 0; i < old_capacity; ++i)
     {
-        std::cout << "性别(男/女): ";
-        std::cin >> stu.gender;
-
-        if (!ValidateGender(stu.gender))
+        if (old_slots[i] != 0)
         {
-            std::cout << "*** 错误: 性别只能输入'男'或'女'! ***" << std::endl;
-            continue;
+            int slot = Home(old_slots[i]);
+            while (slots_[slot] != 0)
+            {
+                slot = (slot + 1) & (capacity_ - 1);
+            }
+            slots_[slot] = old_slots[i];
         }
-
-        break;
     }
+    delete[] old_slots;
+}
 
-    // 输入年龄
-    while (true)
+void IdSet::Add(int id)
+{
+    // 装载因子不超过 1/2
+    if ((size_ + 1) * 2 > capacity_)
     {
-        std::cout << "年龄: ";
-        if (!(std::cin >> stu.age))
+        Resize(capacity_ == 0 ? 8 : capacity_ * 2);
+    }
+    int slot = Home(id);
+    while (slots_[slot] != 0)
+    {
+        if (slots_[slot] == id)
         {
-            std::cout << "*** 错误: 年龄必须是数字! 请重新输入。***" << std::endl;
-            ClearInputBuffer();
-            continue;
+            return;
         }
+        slot = (slot + 1) & (capacity_ - 1);
+    }
+    slots_[slot] = id;
+    size_++;
+}
 
-        if (!ValidateAge(stu.age))
+bool IdSet::Remove(int id)
+{
+    if (capacity_ == 0)
+    {
+        return false;
+    }
+    int mask = capacity_ - 1;
+    int hole = Home(id);
+    while (slots_[hole] != id)
+    {
+        if (slots_[hole] == 0)
         {
-            std::cout << "*** 错误: 年龄必须在 10-100 之间! ***" << std::endl;
-            continue;
+            return false;
         }
-
-        break;
+        hole = (hole + 1) & mask;
     }
 
-    // 输入报考类别
-    while (true)
+    // 后移删除: 把探测链上后续的元素前移补洞, 不留墓碑
+    slots_[hole] = 0;
+    for (int next = (hole + 1) & mask; slots_[next] != 0; next = (next + 1) & mask)
     {
-        std::cout << "报考类别: ";
-        std::cin >> stu.category;
-
-        int category_len = std::strlen(stu.category);
-        if (category_len == 0 || category_len >= 50)
+        int home = Home(slots_[next]);
+        if (((next - home) & mask) >= ((next - hole) & mask))
         {
-            std::cout << "*** 错误: 报考类别长度必须在 1-49 个字符之间! ***" << std::endl;
-            continue;
+            slots_[hole] = slots_[next];
+            slots_[next] = 0;
+            hole = next;
         }
-
-        break;
     }
+    size_--;
 
+    if (capacity_ > 8 && size_ * 8 < capacity_)
+    {
+        Resize(capacity_ / 2);
+    }
     return true;
 }
 
-// ==================== 核心功能函数 ====================
-void ExamRegistrationSystem::Initialize()
+void IdSet::Clear()
 {
-    PrintTitle("考 生 报 名 系 统");
-    std::cout << "\n欢迎使用考生报名系统!" << std::endl;
-    std::cout << "首先请建立考生信息数据库。\n"
-              << std::endl;
-
-    int num;
-    while (true)
-    {
-        std::cout << "请输入考生人数: ";
-        if (!(std::cin >> num))
-        {
-            std::cout << "*** 错误: 请输入有效的数字! ***" << std::endl;
-            ClearInputBuffer();
-            continue;
-        }
+    delete[] slots_;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+}
 
-        if (num <= 0)
-        {
-            std::cout << "*** 错误: 考生人数必须大于 0! ***" << std::endl;
-            continue;
-        }
+// ==================== 二级索引 ====================
+// 随增删改同步维护:
+//   报考类别 -> 考号集合 (按类别字典编号直接索引)
+//   年龄 -> 考号集合     (年龄取值有限, 直接按年龄分桶, 桶有序)
+//   性别 -> 人数
+// 年龄区间计数用树状数组, 为 O(log 年龄范围); 列举为 O(年龄范围 + 结果数)。
+class SecondaryIndex
+{
+public:
+    SecondaryIndex();
+    ~SecondaryIndex();
 
-        if (num > 10000)
-        {
-            std::cout << "*** 错误: 考生人数过多! 建议不超过 10000 人。***" << std::endl;
-            continue;
-        }
+    void Add(const StudentRecord &record);
+    void Remove(const StudentRecord &record);
+    void Clear();
 
-        break;
-    }
+    // 某报考类别(字典编号)的人数
+    int CountByCategory(int category) const;
 
-    std::cout << "\n请依次输入每位考生的信息:" << std::endl;
-    PrintSeparator('-');
+    // 依次访问某报考类别下的考号
+    template <typename Visitor>
+    void ForEachInCategory(int category, Visitor &visit) const;
 
-    for (int i = 0; i < num; ++i)
-    {
-        std::cout << "\n第 " << (i + 1) << " 位考生:" << std::endl;
-        Student stu;
+    // 依次访问每个有考生的报考类别编号及其人数
+    template <typename Visitor>
+    void ForEachCategory(Visitor &visit) const;
 
-        if (!InputStudent(stu, true))
-        {
-            std::cout << "*** 输入失败! ***" << std::endl;
-            --i;
-            continue;
-        }
+    // 年龄在 [min_age, max_age] 内的人数
+    int CountByAgeRange(int min_age, int max_age) const;
 
-        // 哈希表头插法
-        Node *new_node = new Node();
-        new_node->data = stu;
+    // 按年龄从小到大访问 [min_age, max_age] 内的考号
+    template <typename Visitor>
+    void ForEachInAgeRange(int min_age, int max_age, Visitor &visit) const;
 
-        int index = Hash(stu.exam_id);
-        new_node->next = table_[index];
-        table_[index] = new_node;
+    // 某性别的人数
+    int CountByGender(Gender gender) const;
 
-        count_++;
+private:
+    static const int AGE_SLOTS = MAX_AGE - MIN_AGE + 1;
 
-        std::cout << ">>> 第 " << (i + 1) << " 位考生信息录入成功! <<<" << std::endl;
-    }
+    IdSet **categories_;          // 类别编号 -> 考号集合, 首次出现时分配
+    int category_capacity_;
+    IdSet ages_[AGE_SLOTS];       // 年龄分桶索引
+    int age_tree_[AGE_SLOTS + 1]; // 各年龄人数的树状数组
+    int gender_counts_[2];        // 按 Gender 计数
 
-    std::cout << "\n*** 考生信息初始化完成! ***" << std::endl;
-    PrintAll();
-}
+    void UpdateAgeCount(int age, int delta);
+    int AgePrefixCount(int age) const; // 年龄 <= age 的人数
+};
 
-void ExamRegistrationSystem::Insert()
+template <typename Visitor>
+void SecondaryIndex::ForEachInCategory(int category, Visitor &visit) const
 {
-    PrintTitle("插入考生信息");
-
-    std::cout << "\n请输入要插入的考生信息:" << std::endl;
-    Student stu;
-
-    if (InputStudent(stu, true))
+    if (category >= 0 && category < category_capacity_ && categories_[category] != nullptr)
     {
-        // 哈希表头插法
-        Node *new_node = new Node();
-        new_node->data = stu;
-
-        int index = Hash(stu.exam_id);
-        new_node->next = table_[index];
-        table_[index] = new_node;
-
-        count_++;
-        std::cout << "\n>>> 考生信息插入成功! <<<" << std::endl;
-        PrintAll();
+        categories_[category]->ForEach(visit);
     }
 }
 
-Node *ExamRegistrationSystem::FindByExamId(int exam_id)
+template <typename Visitor>
+void SecondaryIndex::ForEachCategory(Visitor &visit) const
 {
-    int index = Hash(exam_id);
-    Node *current = table_[index];
-    while (current != nullptr)
+    for (int i = 0; i < category_capacity_; ++i)
     {
-        if (current->data.exam_id == exam_id)
+        if (categories_[i] != nullptr && categories_[i]->Size() > 0)
         {
-            return current;
+            visit(i, categories_[i]->Size());
         }
-        current = current->next;
     }
-    return nullptr;
 }
 
-bool ExamRegistrationSystem::DeleteByExamId(int exam_id)
+template <typename Visitor>
+void SecondaryIndex::ForEachInAgeRange(int min_age, int max_age, Visitor &visit) const
 {
-    int index = Hash(exam_id);
-    Node *current = table_[index];
-    Node *prev = nullptr;
-
-    while (current != nullptr)
+    if (min_age < MIN_AGE)
     {
-        if (current->data.exam_id == exam_id)
-        {
-            if (prev == nullptr)
-            {
-                table_[index] = current->next;
-            }
-            else
-            {
-                prev->next = current->next;
-            }
-
-            std::cout << "\n你删除的考生信息是:" << std::endl;
-            PrintHeader();
-            PrintStudent(current->data);
-            PrintSeparator('-');
-
-            delete current;
-            count_--;
-            return true;
-        }
-        prev = current;
-        current = current->next;
+        min_age = MIN_AGE;
     }
+    if (max_age > MAX_AGE)
+    {
+        max_age = MAX_AGE;
+    }
+    for (int age = min_age; age <= max_age; ++age)
+    {
+        ages_[age - MIN_AGE].ForEach(visit);
+    }
+}
 
-    return false;
+SecondaryIndex::SecondaryIndex() : categories_(nullptr), category_capacity_(0)
+{
+    std::memset(age_tree_, 0, sizeof(age_tree_));
+    gender_counts_[0] = 0;
+    gender_counts_[1] = 0;
 }
 
-void ExamRegistrationSystem::Delete()
+SecondaryIndex::~SecondaryIndex()
 {
-    PrintTitle("删除考生信息");
+    Clear();
+}
 
-    if (count_ == 0)
+void SecondaryIndex::UpdateAgeCount(int age, int delta)
+{
+    for (int i = age - MIN_AGE + 1; i <= AGE_SLOTS; i += i & -i)
     {
-        std::cout << "\n*** 当前系统中暂无考生信息! ***\n"
-                  << std::endl;
-        return;
+        age_tree_[i] += delta;
     }
+}
 
-    int exam_id;
-    while (true)
+int SecondaryIndex::AgePrefixCount(int age) const
+{
+    int count = 0;
+    for (int i = age - MIN_AGE + 1; i > 0; i -= i & -i)
     {
-        std::cout << "请输入要删除的考生考号: ";
-        if (!(std::cin >> exam_id))
+        count += age_tree_[i];
+    }
+    return count;
+}
+
+void SecondaryIndex::Add(const StudentRecord &record)
+{
+    if (record.category >= category_capacity_)
+    {
+        int capacity = category_capacity_ > 0 ? category_capacity_ : 16;
+        while (capacity <= record.category)
         {
-            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
-            ClearInputBuffer();
-            continue;
+            capacity *= 2;
         }
-        break;
+        IdSet **categories = new IdSet *[capacity]();
+        for (int i = 0; i < category_capacity_; ++i)
+        {
+            categories[i] = categories_[i];
+        }
+        delete[] categories_;
+        categories_ = categories;
+        category_capacity_ = capacity;
+    }
+    if (categories_[record.category] == nullptr)
+    {
+        categories_[record.category] = new IdSet();
     }
+    categories_[record.category]->Add(record.exam_id);
 
-    if (DeleteByExamId(exam_id))
+    ages_[record.age - MIN_AGE].Add(record.exam_id);
+    UpdateAgeCount(record.age, 1);
+    gender_counts_[record.gender]++;
+}
+
+void SecondaryIndex::Remove(const StudentRecord &record)
+{
+    if (record.category < category_capacity_ && categories_[record.category] != nullptr)
     {
-        std::cout << ">>> 考生信息删除成功! <<<" << std::endl;
-        PrintAll();
+        categories_[record.category]->Remove(record.exam_id);
     }
-    else
+    if (ages_[record.age - MIN_AGE].Remove(record.exam_id))
     {
-        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
-                  << std::endl;
+        UpdateAgeCount(record.age, -1);
     }
+    gender_counts_[record.gender]--;
 }
 
-void ExamRegistrationSystem::Search()
+void SecondaryIndex::Clear()
 {
-    PrintTitle("查找考生信息");
+    for (int i = 0; i < category_capacity_; ++i)
+    {
+        delete categories_[i];
+    }
+    delete[] categories_;
+    categories_ = nullptr;
+    category_capacity_ = 0;
+    for (int i = 0; i < AGE_SLOTS; ++i)
+    {
+        ages_[i].Clear();
+    }
+    std::memset(age_tree_, 0, sizeof(age_tree_));
+    gender_counts_[0] = 0;
+    gender_counts_[1] = 0;
+}
 
-    int exam_id;
-    while (true)
+int SecondaryIndex::CountByCategory(int category) const
+{
+    if (category < 0 || category >= category_capacity_ || categories_[category] == nullptr)
     {
-        std::cout << "请输入要查找的考生考号: ";
-        if (!(std::cin >> exam_id))
-        {
-            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
-            ClearInputBuffer();
-            continue;
-        }
-        break;
+        return 0;
     }
+    return categories_[category]->Size();
+}
 
-    Node *node = FindByExamId(exam_id);
-    if (node != nullptr)
+int SecondaryIndex::CountByAgeRange(int min_age, int max_age) const
+{
+    if (min_age < MIN_AGE)
     {
-        std::cout << "\n查找结果:" << std::endl;
-        PrintHeader();
-        PrintStudent(node->data);
-        PrintSeparator('-');
+        min_age = MIN_AGE;
     }
-    else
+    if (max_age > MAX_AGE)
     {
-        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
-                  << std::endl;
+        max_age = MAX_AGE;
+    }
+    if (min_age > max_age)
+    {
+        return 0;
     }
+    return AgePrefixCount(max_age) - AgePrefixCount(min_age - 1);
 }
 
-void ExamRegistrationSystem::Modify()
+int SecondaryIndex::CountByGender(Gender gender) const
 {
-    PrintTitle("修改考生信息");
+    return gender_counts_[gender];
+}
 
-    int exam_id;
-    while (true)
+// ==================== 考号有序索引 ====================
+// 有序分块: 考号按升序分存在若干定长块中, 另有一张按块首考号升序排列的目录。
+// 定位某个考号先在目录上二分找到块, 再在块内二分, 为 O(log n);
+// 区间扫描定位起点后沿块顺序输出, 为 O(log n + k)。
+// 插入时块满则对半分裂, 删除后与后继块合计不超过半块时合并, 空块直接摘除,
+// 因此每块至少有一个考号, 顺序扫描访问的块数不超过 k + 1。
+class OrderedIdIndex
+{
+public:
+    OrderedIdIndex() : blocks_(nullptr), first_ids_(nullptr), block_count_(0), capacity_(0), size_(0) {}
+    ~OrderedIdIndex() { Clear(); }
+
+    void Insert(int id);
+    bool Erase(int id);
+    void Clear();
+    int Size() const { return size_; }
+
+    // 按考号升序访问全部考号
+    template <typename Visitor>
+    void ForEach(Visitor &visit) const;
+
+    // 按考号升序访问 [low, high] 内的考号
+    template <typename Visitor>
+    void ForEachInRange(int low, int high, Visitor &visit) const;
+
+private:
+    static const int BLOCK_CAPACITY = 512;
+
+    struct Block
     {
-        std::cout << "请输入要修改的考生考号: ";
-        if (!(std::cin >> exam_id))
+        int count;
+        int ids[BLOCK_CAPACITY];
+    };
+
+    Block **blocks_;  // 按考号升序排列的块
+    int *first_ids_;  // 各块首考号, 与 blocks_ 一一对应
+    int block_count_;
+    int capacity_;    // 目录容量
+    int size_;
+
+    // 最后一个首考号不大于 id 的块(id 比全部考号都小时为 0)
+    int FindBlock(int id) const;
+
+    // 块内第一个不小于 id 的位置
+    static int LowerBound(const Block *block, int id);
+
+    void InsertBlock(int index, Block *block);
+    void RemoveBlock(int index);
+};
+
+template <typename Visitor>
+void OrderedIdIndex::ForEach(Visitor &visit) const
+{
+    for (int b = 0; b < block_count_; ++b)
+    {
+        const Block *block = blocks_[b];
+        for (int i = 0; i < block->count; ++i)
         {
-            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
-            ClearInputBuffer();
-            continue;
+            visit(block->ids[i]);
         }
-        break;
     }
+}
 
-    Node *node = FindByExamId(exam_id);
-    if (node != nullptr)
+template <typename Visitor>
+void OrderedIdIndex::ForEachInRange(int low, int high, Visitor &visit) const
+{
+    if (block_count_ == 0 || low > high)
     {
-        std::cout << "\n当前考生信息:" << std::endl;
-        PrintHeader();
-        PrintStudent(node->data);
-        PrintSeparator('-');
-
-        std::cout << "\n请输入修改后的信息 (考号不可修改):" << std::endl;
-
-        Student temp_stu;
-        temp_stu.exam_id = node->data.exam_id; // 保持考号不变
-
-        // 输入姓名
-        while (true)
+        return;
+    }
+    int b = FindBlock(low);
+    int i = LowerBound(blocks_[b], low);
+    for (; b < block_count_; ++b, i = 0)
+    {
+        const Block *block = blocks_[b];
+        for (; i < block->count; ++i)
         {
-            std::cout << "姓名: ";
-            std::cin >> temp_stu.name;
-
-            int name_len = std::strlen(temp_stu.name);
-            if (name_len == 0 || name_len >= 50)
+            if (block->ids[i] > high)
             {
-                std::cout << "*** 错误: 姓名长度必须在 1-49 个字符之间! ***" << std::endl;
-                continue;
+                return;
             }
-            break;
+            visit(block->ids[i]);
         }
+    }
+}
 
-        // 输入性别
-        while (true)
+int OrderedIdIndex::FindBlock(int id) const
+{
+    int low = 0;
+    int high = block_count_ - 1;
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+        if (first_ids_[mid] <= id)
         {
-            std::cout << "性别(男/女): ";
-            std::cin >> temp_stu.gender;
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
 
-            if (!ValidateGender(temp_stu.gender))
-            {
-                std::cout << "*** 错误: 性别只能输入'男'或'女'! ***" << std::endl;
-                continue;
-            }
-            break;
+int OrderedIdIndex::LowerBound(const Block *block, int id)
+{
+    int low = 0;
+    int high = block->count;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (block->ids[mid] < id)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
         }
+    }
+    return low;
+}
 
-        // 输入年龄
-        while (true)
+void OrderedIdIndex::InsertBlock(int index, Block *block)
+{
+    if (block_count_ == capacity_)
+    {
+        int capacity = capacity_ > 0 ? capacity_ * 2 : 16;
+        Block **blocks = new Block *[capacity];
+        int *first_ids = new int[capacity];
+        for (int i = 0; i < block_count_; ++i)
         {
-            std::cout << "年龄: ";
-            if (!(std::cin >> temp_stu.age))
-            {
-                std::cout << "*** 错误: 年龄必须是数字! ***" << std::endl;
-                ClearInputBuffer();
-                continue;
-            }
+            blocks[i] = blocks_[i];
+            first_ids[i] = first_ids_[i];
+        }
+        delete[] blocks_;
+        delete[] first_ids_;
+        blocks_ = blocks;
+        first_ids_ = first_ids;
+        capacity_ = capacity;
+    }
+    for (int i = block_count_; i > index; --i)
+    {
+        blocks_[i] = blocks_[i - 1];
+        first_ids_[i] = first_ids_[i - 1];
+    }
+    blocks_[index] = block;
+    first_ids_[index] = block->ids[0];
+    block_count_++;
+}
 
-            if (!ValidateAge(temp_stu.age))
-            {
-                std::cout << "*** 错误: 年龄必须在 10-100 之间! ***" << std::endl;
-                continue;
-            }
-            break;
+void OrderedIdIndex::RemoveBlock(int index)
+{
+    delete blocks_[index];
+    for (int i = index; i + 1 < block_count_; ++i)
+    {
+        blocks_[i] = blocks_[i + 1];
+        first_ids_[i] = first_ids_[i + 1];
+    }
+    block_count_--;
+}
+
+void OrderedIdIndex::Insert(int id)
+{
+    if (block_count_ == 0)
+    {
+        Block *block = new Block;
+        block->count = 1;
+        block->ids[0] = id;
+        InsertBlock(0, block);
+        size_++;
+        return;
+    }
+
+    int b = FindBlock(id);
+    Block *block = blocks_[b];
+    int pos = LowerBound(block, id);
+    if (block->count == BLOCK_CAPACITY)
+    {
+        // 对半分裂, 后一半移入新块
+        Block *right = new Block;
+        int half = BLOCK_CAPACITY / 2;
+        right->count = BLOCK_CAPACITY - half;
+        std::memcpy(right->ids, block->ids + half, sizeof(int) * right->count);
+        block->count = half;
+        InsertBlock(b + 1, right);
+        if (pos > half)
+        {
+            block = right;
+            pos -= half;
+            b++;
         }
+    }
+    std::memmove(block->ids + pos + 1, block->ids + pos, sizeof(int) * (block->count - pos));
+    block->ids[pos] = id;
+    block->count++;
+    first_ids_[b] = block->ids[0];
+    size_++;
+}
 
-        // 输入报考类别
-        while (true)
+bool OrderedIdIndex::Erase(int id)
+{
+    if (block_count_ == 0)
+    {
+        return false;
+    }
+    int b = FindBlock(id);
+    Block *block = blocks_[b];
+    int pos = LowerBound(block, id);
+    if (pos == block->count || block->ids[pos] != id)
+    {
+        return false;
+    }
+    block->count--;
+    std::memmove(block->ids + pos, block->ids + pos + 1, sizeof(int) * (block->count - pos));
+    size_--;
+
+    if (block->count == 0)
+    {
+        RemoveBlock(b);
+        return true;
+    }
+    first_ids_[b] = block->ids[0];
+
+    // 与后继块合计不超过半块时合并, 避免删除后留下大量稀疏块
+    if (b + 1 < block_count_ && block->count + blocks_[b + 1]->count <= BLOCK_CAPACITY / 2)
+    {
+        Block *next = blocks_[b + 1];
+        std::memcpy(block->ids + block->count, next->ids, sizeof(int) * next->count);
+        block->count += next->count;
+        RemoveBlock(b + 1);
+    }
+    return true;
+}
+
+void OrderedIdIndex::Clear()
+{
+    for (int i = 0; i < block_count_; ++i)
+    {
+        delete blocks_[i];
+    }
+    delete[] blocks_;
+    delete[] first_ids_;
+    blocks_ = nullptr;
+    first_ids_ = nullptr;
+    block_count_ = 0;
+    capacity_ = 0;
+    size_ = 0;
+}
+
+// ==================== 姓名前缀树 ====================
+// 以 Unicode 字符(按 UTF-8 解码)为边的前缀树, 一个汉字占一层而不是三层字节。
+// 子结点查找走全局边表: 以 (父结点, 字符) 为键的线性探测散列, 每层 O(1);
+// 同时每个结点用双向兄弟链表串起子结点, 供前缀查询遍历子树。
+// 同名考生挂在同一结点的考号链表上。精确查找为 O(姓名长度 + 同名人数),
+// 前缀查找为 O(前缀长度 + 子树结点数), 子树中每个叶子都至少对应一名考生。
+class NameTrie
+{
+public:
+    NameTrie();
+    ~NameTrie();
+
+    void Add(const char *name, int exam_id);
+    void Remove(const char *name, int exam_id);
+    void Clear();
+
+    // 访问姓名恰为 name 的考号
+    template <typename Visitor>
+    void ForEachExact(const char *name, Visitor &visit) const;
+
+    // 访问姓名以 prefix 开头的考号
+    template <typename Visitor>
+    void ForEachWithPrefix(const char *prefix, Visitor &visit) const;
+
+private:
+    struct TrieNode
+    {
+        int code_point;   // 父结点到本结点的字符
+        int parent;
+        int first_child;
+        int prev_sibling;
+        int next_sibling; // 释放后借作空闲链表指针
+        int ids;          // 考号链表头(下标指向 links_), -1 为空
+    };
+
+    struct IdLink
+    {
+        int exam_id;
+        int next; // 释放后借作空闲链表指针
+    };
+
+    TrieNode *nodes_; // nodes_[0] 为根
+    int node_count_;
+    int node_capacity_;
+    int free_node_;
+    IdLink *links_;
+    int link_count_;
+    int link_capacity_;
+    int free_link_;
+    int *edges_;      // 边表, 保存子结点下标, -1 为空; 槽数为 2 的幂且不少于结点数的 2 倍
+    int edge_capacity_;
+    int edge_count_;
+
+    // 解码 p 处的一个 UTF-8 字符并前移; 非法字节按单字节映射到 0xDC00 + 字节值
+    static int DecodeUtf8(const unsigned char *&p);
+
+    int EdgeHome(int parent, int code_point) const;
+    int FindChild(int parent, int code_point) const;
+    int FindNode(const char *text) const;
+    int AddChild(int parent, int code_point);
+    void RemoveNode(int node);
+    void EraseEdge(int node);
+    void GrowEdges();
+    int NewNode();
+    int NewLink();
+};
+
+template <typename Visitor>
+void NameTrie::ForEachExact(const char *name, Visitor &visit) const
+{
+    int node = FindNode(name);
+    for (int link = node > 0 ? nodes_[node].ids : -1; link >= 0; link = links_[link].next)
+    {
+        visit(links_[link].exam_id);
+    }
+}
+
+template <typename Visitor>
+void NameTrie::ForEachWithPrefix(const char *prefix, Visitor &visit) const
+{
+    int root = FindNode(prefix);
+    if (root < 0)
+    {
+        return;
+    }
+    // 借助父/子/兄弟指针做先序遍历, 不需要额外的栈
+    int node = root;
+    while (true)
+    {
+        for (int link = nodes_[node].ids; link >= 0; link = links_[link].next)
         {
-            std::cout << "报考类别: ";
-            std::cin >> temp_stu.category;
+            visit(links_[link].exam_id);
+        }
+        if (nodes_[node].first_child >= 0)
+        {
+            node = nodes_[node].first_child;
+            continue;
+        }
+        while (node != root && nodes_[node].next_sibling < 0)
+        {
+            node = nodes_[node].parent;
+        }
+        if (node == root)
+        {
+            return;
+        }
+        node = nodes_[node].next_sibling;
+    }
+}
 
-            int category_len = std::strlen(temp_stu.category);
-            if (category_len == 0 || category_len >= 50)
-            {
-                std::cout << "*** 错误: 报考类别长度必须在 1-49 个字符之间! ***" << std::endl;
-                continue;
-            }
+NameTrie::NameTrie()
+    : nodes_(nullptr), node_count_(0), node_capacity_(0), free_node_(-1),
+      links_(nullptr), link_count_(0), link_capacity_(0), free_link_(-1),
+      edges_(nullptr), edge_capacity_(0), edge_count_(0)
+{
+    Clear();
+}
+
+NameTrie::~NameTrie()
+{
+    delete[] nodes_;
+    delete[] links_;
+    delete[] edges_;
+}
+
+int NameTrie::DecodeUtf8(const unsigned char *&p)
+{
+    unsigned char lead = *p;
+    int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    int code_point = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+    for (int i = 1; i < length; ++i)
+    {
+        if ((p[i] & 0xC0) != 0x80)
+        {
+            length = 0; // 续字节不完整
             break;
         }
+        code_point = (code_point << 6) | (p[i] & 0x3F);
+    }
+    if (length == 0)
+    {
+        ++p;
+        return 0xDC00 + lead;
+    }
+    p += length;
+    return code_point;
+}
 
-        // 更新信息
-        node->data = temp_stu;
+int NameTrie::EdgeHome(int parent, int code_point) const
+{
+    unsigned int hash = (unsigned int)parent * 2654435769u ^ (unsigned int)code_point * 2246822519u;
+    return (hash ^ (hash >> 15)) & (edge_capacity_ - 1);
+}
 
-        std::cout << "\n>>> 考生信息修改成功! <<<" << std::endl;
-        PrintAll();
+int NameTrie::FindChild(int parent, int code_point) const
+{
+    int mask = edge_capacity_ - 1;
+    for (int slot = EdgeHome(parent, code_point); edges_[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        const TrieNode &child = nodes_[edges_[slot]];
+        if (child.parent == parent && child.code_point == code_point)
+        {
+            return edges_[slot];
+        }
     }
-    else
+    return -1;
+}
+
+int NameTrie::FindNode(const char *text) const
+{
+    int node = 0;
+    for (const unsigned char *p = (const unsigned char *)text; *p != '\0' && node >= 0;)
     {
-        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
-                  << std::endl;
+        node = FindChild(node, DecodeUtf8(p));
     }
+    return node;
 }
 
-void ExamRegistrationSystem::Statistics()
+int NameTrie::NewNode()
 {
-    PrintTitle("统计考生信息");
-    PrintAll();
+    if (free_node_ >= 0)
+    {
+        int node = free_node_;
+        free_node_ = nodes_[node].next_sibling;
+        return node;
+    }
+    if (node_count_ == node_capacity_)
+    {
+        node_capacity_ = node_capacity_ > 0 ? node_capacity_ * 2 : 64;
+        TrieNode *nodes = new TrieNode[node_capacity_];
+        if (node_count_ > 0)
+        {
+            std::memcpy(nodes, nodes_, sizeof(TrieNode) * node_count_);
+        }
+        delete[] nodes_;
+        nodes_ = nodes;
+    }
+    return node_count_++;
 }
 
-void ExamRegistrationSystem::Run()
+int NameTrie::NewLink()
+{
+    if (free_link_ >= 0)
+    {
+        int link = free_link_;
+        free_link_ = links_[link].next;
+        return link;
+    }
+    if (link_count_ == link_capacity_)
+    {
+        link_capacity_ = link_capacity_ > 0 ? link_capacity_ * 2 : 64;
+        IdLink *links = new IdLink[link_capacity_];
+        if (link_count_ > 0)
+        {
+            std::memcpy(links, links_, sizeof(IdLink) * link_count_);
+        }
+        delete[] links_;
+        links_ = links;
+    }
+    return link_count_++;
+}
+
+void NameTrie::GrowEdges()
 {
-    Initialize();
+    delete[] edges_;
+    edge_capacity_ *= 2;
+    edges_ = new int[edge_capacity_];
+    for (int i = 0; i < edge_capacity_; ++i)
+    {
+        edges_[i] = -1;
+    }
+    // 重新登记所有在用结点(根与空闲结点除外)
+    int mask = edge_capacity_ - 1;
+    for (int node = 1; node < node_count_; ++node)
+    {
+        if (nodes_[node].parent >= 0)
+        {
+            int slot = EdgeHome(nodes_[node].parent, nodes_[node].code_point);
+            while (edges_[slot] >= 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+            edges_[slot] = node;
+        }
+    }
+}
 
-    char choice;
-    while (true)
+int NameTrie::AddChild(int parent, int code_point)
+{
+    if ((edge_count_ + 1) * 2 > edge_capacity_)
     {
-        ShowMenu();
-        std::cout << "请选择操作 [0-5]: ";
-        std::cin >> choice;
+        GrowEdges();
+    }
+    int node = NewNode();
+    TrieNode &child = nodes_[node];
+    child.code_point = code_point;
+    child.parent = parent;
+    child.first_child = -1;
+    child.prev_sibling = -1;
+    child.next_sibling = nodes_[parent].first_child;
+    child.ids = -1;
+    if (child.next_sibling >= 0)
+    {
+        nodes_[child.next_sibling].prev_sibling = node;
+    }
+    nodes_[parent].first_child = node;
 
-        switch (choice)
+    int mask = edge_capacity_ - 1;
+    int slot = EdgeHome(parent, code_point);
+    while (edges_[slot] >= 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    edges_[slot] = node;
+    edge_count_++;
+    return node;
+}
+
+void NameTrie::EraseEdge(int node)
+{
+    int mask = edge_capacity_ - 1;
+    int hole = EdgeHome(nodes_[node].parent, nodes_[node].code_point);
+    while (edges_[hole] != node)
+    {
+        hole = (hole + 1) & mask;
+    }
+    // 后移删除, 与考号集合相同
+    edges_[hole] = -1;
+    for (int next = (hole + 1) & mask; edges_[next] >= 0; next = (next + 1) & mask)
+    {
+        int home = EdgeHome(nodes_[edges_[next]].parent, nodes_[edges_[next]].code_point);
+        if (((next - home) & mask) >= ((next - hole) & mask))
         {
-        case '1':
-            Insert();
-            break;
-        case '2':
-            Delete();
-            break;
-        case '3':
-            Search();
-            break;
-        case '4':
-            Modify();
-            break;
-        case '5':
-            Statistics();
-            break;
-        case '0':
-            PrintSeparator('=');
-            std::cout << "\n感谢使用考生报名系统! 再见!\n"
-                      << std::endl;
-            PrintSeparator('=');
-            return;
-        default:
-            std::cout << "\n*** 错误: 无效的操作! 请输入 0-5 之间的数字。***\n"
-                      << std::endl;
-            ClearInputBuffer();
-            break;
+            edges_[hole] = edges_[next];
+            edges_[next] = -1;
+            hole = next;
         }
     }
+    edge_count_--;
 }
-// ==================== 主函数 ====================
-int main()
+
+void NameTrie::RemoveNode(int node)
 {
-    ExamRegistrationSystem system;
-    system.Run();
-    return 0;
+    // 自下而上摘除既无考号也无子结点的结点
+    while (node > 0 && nodes_[node].ids < 0 && nodes_[node].first_child < 0)
+    {
+        TrieNode &current = nodes_[node];
+        int parent = current.parent;
+        EraseEdge(node);
+        if (current.prev_sibling >= 0)
+        {
+            nodes_[current.prev_sibling].next_sibling = current.next_sibling;
+        }
+        else
+        {
+            nodes_[parent].first_child = current.next_sibling;
+        }
+        if (current.next_sibling >= 0)
+        {
+            nodes_[current.next_sibling].prev_sibling = current.prev_sibling;
+        }
+        current.parent = -1;
+        current.next_sibling = free_node_;
+        free_node_ = node;
+        node = parent;
+    }
+}
+
+void NameTrie::Add(const char *name, int exam_id)
+{
+    int node = 0;
+    for (const unsigned char *p = (const unsigned char *)name; *p != '\0';)
+    {
+        int code_point = DecodeUtf8(p);
+        int child = FindChild(node, code_point);
+        node = child >= 0 ? child : AddChild(node, code_point);
+    }
+    int link = NewLink();
+    links_[link].exam_id = exam_id;
+    links_[link].next = nodes_[node].ids;
+    nodes_[node].ids = link;
+}
+
+void NameTrie::Remove(const char *name, int exam_id)
+{
+    int node = FindNode(name);
+    if (node < 0)
+    {
+        return;
+    }
+    for (int *link = &nodes_[node].ids; *link >= 0; link = &links_[*link].next)
+    {
+        if (links_[*link].exam_id == exam_id)
+        {
+            int removed = *link;
+            *link = links_[removed].next;
+            links_[removed].next = free_link_;
+            free_link_ = removed;
+            break;
+        }
+    }
+    RemoveNode(node);
+}
+
+// 清空后只剩根结点
+void NameTrie::Clear()
+{
+    delete[] nodes_;
+    delete[] links_;
+    delete[] edges_;
+    nodes_ = nullptr;
+    links_ = nullptr;
+    node_count_ = 0;
+    node_capacity_ = 0;
+    free_node_ = -1;
+    link_count_ = 0;
+    link_capacity_ = 0;
+    free_link_ = -1;
+    edge_capacity_ = 64;
+    edge_count_ = 0;
+    edges_ = new int[edge_capacity_];
+    for (int i = 0; i < edge_capacity_; ++i)
+    {
+        edges_[i] = -1;
+    }
+
+    int root = NewNode();
+    nodes_[root].code_point = 0;
+    nodes_[root].parent = -1;
+    nodes_[root].first_child = -1;
+    nodes_[root].prev_sibling = -1;
+    nodes_[root].next_sibling = -1;
+    nodes_[root].ids = -1;
+}
+
+// ==================== 预写日志 ====================
+// 每次增删改追加一条定长头部 + 可选 Student 负载的二进制记录。
+// 记录先进入内存缓冲, 攒满 batch_size 条或最早一条等待超过 interval 时
+// 才一次写出并 fsync(组提交); 交互界面等待输入前也会提交一次。
+enum WalOp
+{
+    WAL_INSERT = 1, // 负载为完整记录
+    WAL_DELETE = 2, // 无负载
+    WAL_MODIFY = 3  // 负载为修改后的完整记录
+};
+
+struct WalEntryHeader
+{
+    unsigned int checksum; // 覆盖 op、exam_id 与负载的校验和
+    int op;                // WalOp
+    int exam_id;
+};
+
+static unsigned int WalChecksum(const WalEntryHeader &header, const Student *record)
+{
+    unsigned int hash = Fnv1a(FNV_OFFSET_BASIS, &header.op, sizeof(header) - sizeof(header.checksum));
+    return record != nullptr ? Fnv1a(hash, record, sizeof(Student)) : hash;
+}
+
+class WriteAheadLog
+{
+public:
+    WriteAheadLog();
+    ~WriteAheadLog();
+
+    // 以追加方式打开日志
+    bool Open(const char *path, int batch_size, int interval_ms);
+
+    // 提交剩余记录并关闭, 提交失败时返回 false(缓冲区中的记录随之丢失)
+    bool Close();
+
+    bool IsOpen() const { return fd_ >= 0; }
+
+    // 追加一条记录(record 为 nullptr 表示无负载), 必要时触发组提交
+    void Append(int op, int exam_id, const Student *record);
+
+    // 写出缓冲区并 fsync; 失败时截掉写了一半的部分并保留缓冲区, 下次提交重试
+    bool Commit();
+
+    // 清空日志与缓冲区(其内容已写入快照)
+    bool Reset();
+
+    // 日志总字节数(含未提交部分)
+    long Size() const { return file_size_ + buffered_; }
+
+private:
+    int fd_;
+    char *buffer_;              // 组提交缓冲区
+    int buffered_;              // 缓冲区已用字节
+    int buffer_capacity_;
+    int pending_;               // 缓冲区中的记录数
+    int batch_size_;            // 攒满多少条提交一次
+    long long interval_us_;     // 最长等待时间
+    long long first_pending_us_; // 缓冲区中最早一条记录的追加时间
+    long file_size_;            // 已写入文件的字节数
+};
+
+WriteAheadLog::WriteAheadLog()
+    : fd_(-1), buffer_(nullptr), buffered_(0), buffer_capacity_(0), pending_(0),
+      batch_size_(1), interval_us_(0), first_pending_us_(0), file_size_(0)
+{
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    Close();
+    delete[] buffer_;
+}
+
+bool WriteAheadLog::Open(const char *path, int batch_size, int interval_ms)
+{
+    Close();
+    fd_ = open(path, O_WRONLY | O_CREAT | O_APPEND, FILE_MODE);
+    if (fd_ < 0)
+    {
+        return false;
+    }
+    file_size_ = lseek(fd_, 0, SEEK_END);
+    batch_size_ = batch_size > 0 ? batch_size : 1;
+    interval_us_ = (long long)interval_ms * 1000;
+    return true;
+}
+
+bool WriteAheadLog::Close()
+{
+    if (fd_ < 0)
+    {
+        return true;
+    }
+    bool ok = Commit();
+    close(fd_);
+    fd_ = -1;
+    buffered_ = 0;
+    pending_ = 0;
+    return ok;
+}
+
+void WriteAheadLog::Append(int op, int exam_id, const Student *record)
+{
+    WalEntryHeader header;
+    header.op = op;
+    header.exam_id = exam_id;
+    header.checksum = WalChecksum(header, record);
+
+    int length = sizeof(header) + (record != nullptr ? sizeof(Student) : 0);
+    if (buffered_ + length > buffer_capacity_)
+    {
+        int capacity = buffer_capacity_ == 0 ? 4096 : buffer_capacity_ * 2;
+        while (capacity < buffered_ + length)
+        {
+            capacity *= 2;
+        }
+        char *buffer = new char[capacity];
+        if (buffered_ > 0)
+        {
+            std::memcpy(buffer, buffer_, buffered_);
+        }
+        delete[] buffer_;
+        buffer_ = buffer;
+        buffer_capacity_ = capacity;
+    }
+    std::memcpy(buffer_ + buffered_, &header, sizeof(header));
+    if (record != nullptr)
+    {
+        std::memcpy(buffer_ + buffered_ + sizeof(header), record, sizeof(Student));
+    }
+    buffered_ += length;
+
+    long long now = NowMicros();
+    if (pending_++ == 0)
+    {
+        first_pending_us_ = now;
+    }
+    if (pending_ >= batch_size_ || now - first_pending_us_ >= interval_us_)
+    {
+        Commit();
+    }
+}
+
+bool WriteAheadLog::Commit()
+{
+    if (fd_ < 0 || pending_ == 0)
+    {
+        return true;
+    }
+    if (!WriteAll(fd_, buffer_, buffered_) || fsync(fd_) != 0)
+    {
+        // 截掉可能已写入的半批记录, 重试时整批重新追加, 日志中不会出现残缺的记录
+        ftruncate(fd_, file_size_);
+        std::cout << "*** 错误: 写入预写日志失败, " << pending_ << " 条修改留在缓冲区等待重试 ***" << std::endl;
+        return false;
+    }
+    file_size_ += buffered_;
+    buffered_ = 0;
+    pending_ = 0;
+    return true;
+}
+
+bool WriteAheadLog::Reset()
+{
+    // 缓冲区中的记录已包含在快照里, 不必再写
+    buffered_ = 0;
+    pending_ = 0;
+    if (fd_ < 0 || ftruncate(fd_, 0) != 0 || fsync(fd_) != 0)
+    {
+        return false;
+    }
+    file_size_ = 0;
+    return true;
+}
+
+// ==================== 考生管理系统类 ====================
+class ExamRegistrationSystem
+{
+public:
+    explicit ExamRegistrationSystem(StorageEngine engine = CHAINING_ENGINE);
+    ~ExamRegistrationSystem();
+
+    // 初始化系统
+    void Initialize();
+
+    // 插入考生
+    void Insert();
+
+    // 删除考生
+    void Delete();
+
+    // 查找考生
+    void Search();
+
+    // 修改考生信息
+    void Modify();
+
+    // 统计考生信息
+    void Statistics();
+
+    // 按报考类别查询
+    void QueryByCategory();
+
+    // 按年龄区间查询
+    void QueryByAgeRange();
+
+    // 按考号区间查询(按考号升序输出)
+    void QueryByExamIdRange();
+
+    // 按姓名查询, 以 * 结尾时按前缀查询
+    void QueryByName();
+
+    // 从 CSV/TSV 文件批量导入考生, 返回成功导入的人数(文件无法打开时返回 -1)
+    int LoadFromFile(const char *path);
+
+    // 保存/载入二进制快照, 成功返回记录数, 失败返回 -1;
+    // 载入时只有文件不存在视为空快照(返回 0); 无法读取、文件损坏或有不合法的记录时返回 -1 且不插入任何记录
+    int SaveSnapshot(const char *path);
+    int LoadSnapshot(const char *path);
+
+    // 批量查找, results[i] 为 exam_ids[i] 对应的考生(不存在为 nullptr)
+    void FindBatch(const int *exam_ids, int n, StudentRecord **results);
+
+    // 核对考号清单文件(每行一个考号), 列出名单中不存在的考号, 返回缺失数
+    int VerifyExamIds(const char *path);
+
+    // 批处理模式: 逐行执行命令文件("-" 为标准输入), 不显示菜单也不重印全表,
+    // 返回失败的命令数(文件无法打开或修改未能写入预写日志时返回 -1)
+    int RunBatch(const char *path);
+
+    // 重放预写日志, 返回重放的记录数(日志不存在时返回 0)
+    int ReplayLog(const char *path);
+
+    // 开启预写日志; snapshot_path 非空时日志超过 compact_bytes 会压缩进快照
+    bool OpenLog(const char *path, const char *snapshot_path,
+                 int batch_size, int interval_ms, long compact_bytes);
+
+    // 提交日志, 有快照路径时压缩进快照, 然后关闭; 有修改既未进日志也未进快照时返回 false
+    bool CloseLog();
+
+    // 运行系统(已导入考生时跳过初始化)
+    void Run();
+
+    // 查询哈希表状态(装载因子、最长链等)
+    TableStats GetTableStats() const;
+
+private:
+    StorageEngine engine_;             // 存储引擎
+    ChainedRecordTable chained_table_; // 哈希表(拉链法)
+    OpenRecordTable open_table_;       // 哈希表(开放定址法)
+    SecondaryIndex index_;             // 类别/年龄/性别二级索引
+    OrderedIdIndex ordered_ids_;       // 考号有序索引
+    NameTrie name_index_;              // 姓名前缀树
+    NameArena names_;                  // 考生姓名区
+    CategoryDictionary categories_;    // 报考类别字典
+    int count_;                        // 考生数量
+    WriteAheadLog wal_;                // 预写日志(未开启时不记录)
+    const char *snapshot_path_;        // 日志压缩的目标快照
+    long compact_bytes_;               // 日志超过该字节数时压缩
+
+    // 依次访问每位考生(按哈希表存放顺序)
+    template <typename Visitor>
+    void ForEachStudent(Visitor &visit);
+
+    // 按考号升序访问 [low, high] 内的考生
+    template <typename Visitor>
+    void ForEachStudentInRange(int low, int high, Visitor &visit);
+
+    // 输出所有考生信息
+    void PrintAll();
+
+    // 输出表头
+    void PrintHeader();
+
+    // 输出单个考生信息
+    void PrintStudent(const StudentRecord &record);
+
+    // 清空链表
+    void Clear();
+
+    // 完整记录与紧凑记录互转; Pack 会把姓名追加到姓名区、类别登记到字典
+    void Pack(const Student &stu, StudentRecord &record);
+    void Unpack(const StudentRecord &record, Student &stu) const;
+
+    // 姓名区中已删除的姓名过多(超过一半且超过 NAME_GARBAGE_LIMIT)时重建姓名区
+    void CompactNames();
+
+    // 按考号查找考生
+    StudentRecord *FindByExamId(int exam_id);
+
+    // 将考生写入存储引擎(调用方保证考号不存在)
+    void InsertRecord(const Student &stu);
+
+    // 从存储引擎删除考生
+    bool RemoveRecord(int exam_id);
+
+    // 用 stu 覆盖已存在的记录 found
+    void UpdateRecord(StudentRecord *found, const Student &stu);
+
+    // 记录一次修改到预写日志, 必要时压缩日志
+    void LogMutation(int op, int exam_id, const Student *record);
+
+    // 将日志压缩进快照; 修改既未提交到日志也未写入快照时返回 false
+    bool CompactLog();
+
+    // 预留容量
+    void Reserve(int n);
+
+    // 解析导入文件中的一行(不检查考号是否重复), 失败时返回原因
+    const char *ParseRecord(const char *begin, const char *end, Student &stu);
+
+    // 执行一条批处理命令, 失败时返回原因
+    const char *ExecuteCommand(const char *begin, const char *end, OutputBuffer &out);
+
+    // 以制表符分隔输出一名考生
+    void AppendRecord(OutputBuffer &out, const StudentRecord &record);
+
+    // 按考号删除
+    bool DeleteByExamId(int exam_id);
+
+    // 检查考号是否存在
+    bool ExamIdExists(int exam_id);
+
+    // 输入考生信息(带合法性检查)
+    bool InputStudent(Student &stu, bool check_duplicate = true);
+
+    // 验证性别输入
+    bool ValidateGender(const char *gender);
+
+    // 验证年龄输入
+    bool ValidateAge(int age);
+
+    // 验证报考类别: 新类别时类别字典须还有空位
+    bool ValidateCategory(const char *category);
+
+    // 验证考号输入
+    bool ValidateExamId(int exam_id);
+
+    // 验证二进制记录(快照): 字符串须在数组内以 '\0' 结尾且非空, 其余规则同文件导入
+    bool ValidateRecord(const Student &stu);
+
+    // 清空输入缓冲区
+    void ClearInputBuffer();
+
+    // 打印分割线
+    void PrintSeparator(char ch = '=', int length = 70);
+
+    // 打印标题
+    void PrintTitle(const char *title);
+
+    // 显示主菜单
+    void ShowMenu();
+};
+
+// ==================== 构造函数和析构函数 ====================
+ExamRegistrationSystem::ExamRegistrationSystem(StorageEngine engine)
+    : engine_(engine), count_(0), snapshot_path_(nullptr), compact_bytes_(0)
+{
+}
+
+ExamRegistrationSystem::~ExamRegistrationSystem()
+{
+    Clear();
+}
+
+// ==================== 辅助函数 ====================
+template <typename Visitor>
+void ExamRegistrationSystem::ForEachStudent(Visitor &visit)
+{
+    // 紧凑记录自带考号, 不必再传键
+    auto by_record = [&](int, StudentRecord &record) { visit(record); };
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        open_table_.ForEach(by_record);
+    }
+    else
+    {
+        chained_table_.ForEach(by_record);
+    }
+}
+
+template <typename Visitor>
+void ExamRegistrationSystem::ForEachStudentInRange(int low, int high, Visitor &visit)
+{
+    auto by_id = [&](int exam_id) { visit(*FindByExamId(exam_id)); };
+    ordered_ids_.ForEachInRange(low, high, by_id);
+}
+
+TableStats ExamRegistrationSystem::GetTableStats() const
+{
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        return open_table_.Stats();
+    }
+    return chained_table_.Stats();
+}
+
+void ExamRegistrationSystem::Clear()
+{
+    open_table_.Clear();
+    chained_table_.Clear();
+    index_.Clear();
+    ordered_ids_.Clear();
+    name_index_.Clear();
+    names_.Clear();
+    categories_.Clear();
+    count_ = 0;
+}
+
+void ExamRegistrationSystem::Pack(const Student &stu, StudentRecord &record)
+{
+    record.exam_id = stu.exam_id;
+    record.name_offset = names_.Add(stu.name);
+    record.category = categories_.Intern(stu.category);
+    record.gender = std::strcmp(stu.gender, "男") == 0 ? GENDER_MALE : GENDER_FEMALE;
+    record.age = stu.age;
+}
+
+void ExamRegistrationSystem::Unpack(const StudentRecord &record, Student &stu) const
+{
+    stu.exam_id = record.exam_id;
+    std::strcpy(stu.name, names_.Get(record.name_offset));
+    std::strcpy(stu.gender, record.gender == GENDER_MALE ? "男" : "女");
+    stu.age = record.age;
+    std::strcpy(stu.category, categories_.Name(record.category));
+}
+
+void ExamRegistrationSystem::CompactNames()
+{
+    if (names_.GarbageBytes() < NAME_GARBAGE_LIMIT || names_.GarbageBytes() * 2 < names_.Size())
+    {
+        return;
+    }
+
+    // 按现存记录把姓名依次拷进新的姓名区并改写偏移
+    NameArena compacted;
+    compacted.Reserve(names_.Size() - names_.GarbageBytes());
+    auto move = [&](StudentRecord &record)
+    {
+        record.name_offset = compacted.Add(names_.Get(record.name_offset));
+    };
+    ForEachStudent(move);
+    names_.Swap(compacted);
+}
+
+void ExamRegistrationSystem::ClearInputBuffer()
+{
+    std::cin.clear();
+    std::cin.ignore(10000, '\n');
+}
+
+void ExamRegistrationSystem::PrintSeparator(char ch, int length)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        std::cout << ch;
+    }
+    std::cout << std::endl;
+}
+
+void ExamRegistrationSystem::PrintTitle(const char *title)
+{
+    PrintSeparator('=');
+    int title_len = std::strlen(title);
+    int padding = (70 - title_len) / 2;
+    for (int i = 0; i < padding; ++i)
+    {
+        std::cout << " ";
+    }
+    std::cout << title << std::endl;
+    PrintSeparator('=');
+}
+
+void ExamRegistrationSystem::ShowMenu()
+{
+    std::cout << std::endl;
+    PrintSeparator('-');
+    std::cout << "  [1] 插入考生信息" << std::endl;
+    std::cout << "  [2] 删除考生信息" << std::endl;
+    std::cout << "  [3] 查找考生信息" << std::endl;
+    std::cout << "  [4] 修改考生信息" << std::endl;
+    std::cout << "  [5] 统计考生信息" << std::endl;
+    std::cout << "  [6] 按类别查询  " << std::endl;
+    std::cout << "  [7] 按年龄查询  " << std::endl;
+    std::cout << "  [8] 按考号区间查询" << std::endl;
+    std::cout << "  [9] 按姓名查询  " << std::endl;
+    std::cout << "  [0] 退出系统   " << std::endl;
+    PrintSeparator('-');
+}
+
+void ExamRegistrationSystem::PrintHeader()
+{
+    PrintSeparator('-');
+    std::cout << "考号\t姓名\t\t性别\t年龄\t报考类别" << std::endl;
+    PrintSeparator('-');
+}
+
+void ExamRegistrationSystem::PrintStudent(const StudentRecord &record)
+{
+    std::cout << record.exam_id << "\t";
+
+    // 姓名对齐处理
+    const char *name = names_.Get(record.name_offset);
+    int name_len = std::strlen(name);
+    std::cout << name;
+    if (name_len < 8)
+    {
+        std::cout << "\t";
+    }
+    std::cout << "\t";
+
+    std::cout << (record.gender == GENDER_MALE ? "男" : "女") << "\t"
+              << (int)record.age << "\t"
+              << categories_.Name(record.category) << std::endl;
+}
+
+void ExamRegistrationSystem::PrintAll()
+{
+    if (count_ == 0)
+    {
+        std::cout << "\n*** 当前系统中暂无考生信息! ***\n"
+                  << std::endl;
+        return;
+    }
+
+    std::cout << std::endl;
+    PrintHeader();
+    // 按考号升序输出
+    auto print = [this](const StudentRecord &record) { PrintStudent(record); };
+    ForEachStudentInRange(0, MAX_EXAM_ID, print);
+    PrintSeparator('-');
+    std::cout << "总计: " << count_ << " 名考生" << std::endl;
+}
+
+// ==================== 验证函数 ====================
+bool ExamRegistrationSystem::ValidateGender(const char *gender)
+{
+    return (std::strcmp(gender, "男") == 0 || std::strcmp(gender, "女") == 0);
+}
+
+bool ExamRegistrationSystem::ValidateAge(int age)
+{
+    return (age >= MIN_AGE && age <= MAX_AGE);
+}
+
+bool ExamRegistrationSystem::ValidateCategory(const char *category)
+{
+    return categories_.Size() < CategoryDictionary::MAX_CATEGORIES || categories_.Find(category) >= 0;
+}
+
+bool ExamRegistrationSystem::ValidateExamId(int exam_id)
+{
+    return (exam_id > 0 && exam_id <= MAX_EXAM_ID);
+}
+
+bool ExamRegistrationSystem::ValidateRecord(const Student &stu)
+{
+    return ValidateExamId(stu.exam_id) && ValidateAge(stu.age) &&
+           std::memchr(stu.name, '\0', sizeof(stu.name)) != nullptr && stu.name[0] != '\0' &&
+           std::memchr(stu.gender, '\0', sizeof(stu.gender)) != nullptr && ValidateGender(stu.gender) &&
+           std::memchr(stu.category, '\0', sizeof(stu.category)) != nullptr && stu.category[0] != '\0';
+}
+
+bool ExamRegistrationSystem::ExamIdExists(int exam_id)
+{
+    return FindByExamId(exam_id) != nullptr;
+}
+
+bool ExamRegistrationSystem::InputStudent(Student &stu, bool check_duplicate)
+{
+    // 输入考号
+    while (true)
+    {
+        std::cout << "考号: ";
+        if (!(std::cin >> stu.exam_id))
+        {
+            std::cout << "*** 错误: 考号必须是数字! 请重新输入。***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+
+        if (!ValidateExamId(stu.exam_id))
+        {
+            std::cout << "*** 错误: 考号必须在 1-999999 之间! ***" << std::endl;
+            continue;
+        }
+
+        if (check_duplicate && ExamIdExists(stu.exam_id))
+        {
+            std::cout << "*** 错误: 考号 " << stu.exam_id << " 已存在! 请使用其他考号。***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    // 输入姓名
+    while (true)
+    {
+        std::cout << "姓名: ";
+        std::cin >> stu.name;
+
+        int name_len = std::strlen(stu.name);
+        if (name_len == 0 || name_len >= 50)
+        {
+            std::cout << "*** 错误: 姓名长度必须在 1-49 个字符之间! ***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    // 输入性别
+    while (true)
+    {
+        std::cout << "性别(男/女): ";
+        std::cin >> stu.gender;
+
+        if (!ValidateGender(stu.gender))
+        {
+            std::cout << "*** 错误: 性别只能输入'男'或'女'! ***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    // 输入年龄
+    while (true)
+    {
+        std::cout << "年龄: ";
+        if (!(std::cin >> stu.age))
+        {
+            std::cout << "*** 错误: 年龄必须是数字! 请重新输入。***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+
+        if (!ValidateAge(stu.age))
+        {
+            std::cout << "*** 错误: 年龄必须在 10-100 之间! ***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    // 输入报考类别
+    while (true)
+    {
+        std::cout << "报考类别: ";
+        std::cin >> stu.category;
+
+        int category_len = std::strlen(stu.category);
+        if (category_len == 0 || category_len >= 50)
+        {
+            std::cout << "*** 错误: 报考类别长度必须在 1-49 个字符之间! ***" << std::endl;
+            continue;
+        }
+
+        if (!ValidateCategory(stu.category))
+        {
+            std::cout << "*** 错误: 报考类别种数已达上限! ***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    return true;
+}
+
+// ==================== 核心功能函数 ====================
+void ExamRegistrationSystem::Initialize()
+{
+    PrintTitle("考 生 报 名 系 统");
+    std::cout << "\n欢迎使用考生报名系统!" << std::endl;
+    std::cout << "首先请建立考生信息数据库。\n"
+              << std::endl;
+
+    int num;
+    while (true)
+    {
+        std::cout << "请输入考生人数: ";
+        if (!(std::cin >> num))
+        {
+            std::cout << "*** 错误: 请输入有效的数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+
+        if (num <= 0)
+        {
+            std::cout << "*** 错误: 考生人数必须大于 0! ***" << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    std::cout << "\n请依次输入每位考生的信息:" << std::endl;
+    PrintSeparator('-');
+
+    for (int i = 0; i < num; ++i)
+    {
+        std::cout << "\n第 " << (i + 1) << " 位考生:" << std::endl;
+        Student stu;
+
+        if (!InputStudent(stu, true))
+        {
+            std::cout << "*** 输入失败! ***" << std::endl;
+            --i;
+            continue;
+        }
+
+        InsertRecord(stu);
+
+        std::cout << ">>> 第 " << (i + 1) << " 位考生信息录入成功! <<<" << std::endl;
+    }
+
+    std::cout << "\n*** 考生信息初始化完成! ***" << std::endl;
+    PrintAll();
+}
+
+// ==================== 批量导入 ====================
+// 去掉字段首尾空白
+static void TrimField(const char *&begin, const char *&end)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\r'))
+    {
+        ++begin;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\r'))
+    {
+        --end;
+    }
+}
+
+// 解析非负整数字段, 非法时返回 false
+static bool ParseIntField(const char *begin, const char *end, int &value)
+{
+    if (begin == end || end - begin > 9)
+    {
+        return false;
+    }
+    value = 0;
+    for (; begin < end; ++begin)
+    {
+        if (*begin < '0' || *begin > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (*begin - '0');
+    }
+    return true;
+}
+
+// 拷贝字符串字段, 长度须在 1..capacity-1 之间
+static bool CopyField(const char *begin, const char *end, char *dst, int capacity)
+{
+    int length = end - begin;
+    if (length <= 0 || length >= capacity)
+    {
+        return false;
+    }
+    std::memcpy(dst, begin, length);
+    dst[length] = '\0';
+    return true;
+}
+
+const char *ExamRegistrationSystem::ParseRecord(const char *begin, const char *end, Student &stu)
+{
+    // 含制表符按 TSV 处理, 含逗号按 CSV 处理, 否则按空白分隔(连续空格视为一个)
+    char sep = ' ';
+    if (std::memchr(begin, '\t', end - begin) != nullptr)
+    {
+        sep = '\t';
+    }
+    else if (std::memchr(begin, ',', end - begin) != nullptr)
+    {
+        sep = ',';
+    }
+
+    const int FIELD_COUNT = 5;
+    const char *field_begin[FIELD_COUNT];
+    const char *field_end[FIELD_COUNT];
+    int fields = 0;
+    const char *p = begin;
+    while (true)
+    {
+        const char *q = (const char *)std::memchr(p, sep, end - p);
+        if (fields < FIELD_COUNT)
+        {
+            field_begin[fields] = p;
+            field_end[fields] = q != nullptr ? q : end;
+            TrimField(field_begin[fields], field_end[fields]);
+        }
+        fields++;
+        if (q == nullptr)
+        {
+            break;
+        }
+        p = q + 1;
+        while (sep == ' ' && p < end && *p == ' ')
+        {
+            ++p;
+        }
+    }
+    if (fields != FIELD_COUNT)
+    {
+        return "字段数不是 5";
+    }
+
+    if (!ParseIntField(field_begin[0], field_end[0], stu.exam_id) || !ValidateExamId(stu.exam_id))
+    {
+        return "考号必须在 1-999999 之间";
+    }
+    if (!CopyField(field_begin[1], field_end[1], stu.name, sizeof(stu.name)))
+    {
+        return "姓名长度必须在 1-49 个字符之间";
+    }
+    if (!CopyField(field_begin[2], field_end[2], stu.gender, sizeof(stu.gender)) || !ValidateGender(stu.gender))
+    {
+        return "性别只能是'男'或'女'";
+    }
+    if (!ParseIntField(field_begin[3], field_end[3], stu.age) || !ValidateAge(stu.age))
+    {
+        return "年龄必须在 10-100 之间";
+    }
+    if (!CopyField(field_begin[4], field_end[4], stu.category, sizeof(stu.category)))
+    {
+        return "报考类别长度必须在 1-49 个字符之间";
+    }
+    if (!ValidateCategory(stu.category))
+    {
+        return "报考类别种数已达上限";
+    }
+    return nullptr;
+}
+
+int ExamRegistrationSystem::LoadFromFile(const char *path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "*** 错误: 无法打开文件 " << path << " ***" << std::endl;
+        return -1;
+    }
+
+    const char *data = file.Data();
+    const char *data_end = data + file.Size();
+
+    // 按行数预留容量, 导入过程中不再触发扩容
+    int line_count = 1;
+    for (const char *p = data; p < data_end; ++p)
+    {
+        line_count += (*p == '\n');
+    }
+    Reserve(count_ + line_count);
+
+    // 只记录前若干条被拒绝行的详情, 其余只计数
+    const int MAX_REPORTED = 20;
+    int rejected_lines[MAX_REPORTED];
+    const char *rejected_reasons[MAX_REPORTED];
+    int rejected = 0;
+    int loaded = 0;
+
+    int line_no = 0;
+    const char *line = data;
+    while (line < data_end)
+    {
+        const char *newline = (const char *)std::memchr(line, '\n', data_end - line);
+        const char *line_end = newline != nullptr ? newline : data_end;
+        line_no++;
+
+        const char *begin = line;
+        const char *end = line_end;
+        TrimField(begin, end);
+        line = line_end + 1;
+
+        // 跳过空行、注释行以及首行表头
+        if (begin == end || *begin == '#' || (line_no == 1 && (*begin < '0' || *begin > '9')))
+        {
+            continue;
+        }
+
+        Student stu;
+        const char *reason = ParseRecord(begin, end, stu);
+        if (reason == nullptr && ExamIdExists(stu.exam_id))
+        {
+            reason = "考号重复";
+        }
+        if (reason != nullptr)
+        {
+            if (rejected < MAX_REPORTED)
+            {
+                rejected_lines[rejected] = line_no;
+                rejected_reasons[rejected] = reason;
+            }
+            rejected++;
+            continue;
+        }
+
+        InsertRecord(stu);
+        loaded++;
+    }
+
+    std::cout << "\n*** 从 " << path << " 导入 " << loaded << " 名考生, 拒绝 "
+              << rejected << " 行 ***\n";
+    for (int i = 0; i < rejected && i < MAX_REPORTED; ++i)
+    {
+        std::cout << "  第 " << rejected_lines[i] << " 行: " << rejected_reasons[i] << '\n';
+    }
+    if (rejected > MAX_REPORTED)
+    {
+        std::cout << "  ... 另有 " << (rejected - MAX_REPORTED) << " 行被拒绝\n";
+    }
+    std::cout << std::flush;
+    return loaded;
+}
+
+// ==================== 考号核对 ====================
+int ExamRegistrationSystem::VerifyExamIds(const char *path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "*** 错误: 无法打开文件 " << path << " ***" << std::endl;
+        return -1;
+    }
+
+    // 先把整份清单解析成考号数组, 再一次性批量查找
+    const char *data = file.Data();
+    const char *data_end = data + file.Size();
+    int capacity = 1;
+    for (const char *p = data; p < data_end; ++p)
+    {
+        capacity += (*p == '\n');
+    }
+    int *exam_ids = new int[capacity];
+    int *line_numbers = new int[capacity];
+    int n = 0;
+    int invalid = 0;
+    int line_no = 0;
+    for (const char *line = data; line < data_end;)
+    {
+        const char *newline = (const char *)std::memchr(line, '\n', data_end - line);
+        const char *begin = line;
+        const char *end = newline != nullptr ? newline : data_end;
+        line = end + 1;
+        line_no++;
+        TrimField(begin, end);
+        if (begin == end)
+        {
+            continue;
+        }
+        if (!ParseIntField(begin, end, exam_ids[n]))
+        {
+            invalid++;
+            continue;
+        }
+        line_numbers[n++] = line_no;
+    }
+
+    StudentRecord **results = new StudentRecord *[n > 0 ? n : 1];
+    long long start = NowMicros();
+    FindBatch(exam_ids, n, results);
+    long long elapsed = NowMicros() - start;
+
+    const int MAX_REPORTED = 20;
+    int missing = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (results[i] == nullptr)
+        {
+            if (missing < MAX_REPORTED)
+            {
+                std::cout << "  第 " << line_numbers[i] << " 行: 考号 " << exam_ids[i] << " 不存在\n";
+            }
+            missing++;
+        }
+    }
+    if (missing > MAX_REPORTED)
+    {
+        std::cout << "  ... 另有 " << (missing - MAX_REPORTED) << " 个考号不存在\n";
+    }
+    std::cout << "*** 核对 " << n << " 个考号: 存在 " << (n - missing) << " 个, 不存在 " << missing
+              << " 个, 无法识别 " << invalid << " 行, 查找用时 " << elapsed / 1000.0 << " ms ***" << std::endl;
+
+    delete[] results;
+    delete[] line_numbers;
+    delete[] exam_ids;
+    return missing;
+}
+
+// ==================== 批处理模式 ====================
+// 命令格式(每行一条, 空行与 # 开头的行忽略):
+//   INSERT <考号> <姓名> <性别> <年龄> <报考类别>   字段也可用逗号或制表符分隔
+//   MODIFY <考号> <姓名> <性别> <年龄> <报考类别>
+//   DELETE <考号>
+//   FIND <考号>                                    输出该考生一行, 不存在时输出"<考号>\t未找到"
+//   RANGE <下限> <上限>                            按考号升序输出区间内的考生, 每人一行
+//   NAME <姓名>                                    输出同名考生, 每人一行
+//   PREFIX <姓名前缀>                              输出姓名以该前缀开头的考生, 每人一行
+// 增删改成功时不输出, 失败时输出行号与原因。
+static bool MatchVerb(const char *begin, const char *end, const char *verb)
+{
+    int length = std::strlen(verb);
+    return end - begin == length && std::memcmp(begin, verb, length) == 0;
+}
+
+const char *ExamRegistrationSystem::ExecuteCommand(const char *begin, const char *end, OutputBuffer &out)
+{
+    const char *verb_end = begin;
+    while (verb_end < end && *verb_end != ' ' && *verb_end != '\t')
+    {
+        ++verb_end;
+    }
+    const char *args = verb_end;
+    while (args < end && (*args == ' ' || *args == '\t'))
+    {
+        ++args;
+    }
+
+    Student stu;
+    if (MatchVerb(begin, verb_end, "INSERT"))
+    {
+        const char *reason = ParseRecord(args, end, stu);
+        if (reason != nullptr)
+        {
+            return reason;
+        }
+        if (ExamIdExists(stu.exam_id))
+        {
+            return "考号重复";
+        }
+        InsertRecord(stu);
+        return nullptr;
+    }
+    if (MatchVerb(begin, verb_end, "MODIFY"))
+    {
+        const char *reason = ParseRecord(args, end, stu);
+        if (reason != nullptr)
+        {
+            return reason;
+        }
+        StudentRecord *found = FindByExamId(stu.exam_id);
+        if (found == nullptr)
+        {
+            return "考号不存在";
+        }
+        UpdateRecord(found, stu);
+        return nullptr;
+    }
+
+    if (MatchVerb(begin, verb_end, "RANGE"))
+    {
+        const char *low_end = args;
+        while (low_end < end && *low_end != ' ' && *low_end != '\t')
+        {
+            ++low_end;
+        }
+        const char *high_begin = low_end;
+        while (high_begin < end && (*high_begin == ' ' || *high_begin == '\t'))
+        {
+            ++high_begin;
+        }
+        int low;
+        int high;
+        if (!ParseIntField(args, low_end, low) || !ParseIntField(high_begin, end, high))
+        {
+            return "考号必须是数字";
+        }
+        auto print = [&](const StudentRecord &record) { AppendRecord(out, record); };
+        ForEachStudentInRange(low, high, print);
+        return nullptr;
+    }
+
+    bool by_name = MatchVerb(begin, verb_end, "NAME");
+    if (by_name || MatchVerb(begin, verb_end, "PREFIX"))
+    {
+        char name[50];
+        if (!CopyField(args, end, name, sizeof(name)))
+        {
+            return "姓名长度必须在 1-49 个字符之间";
+        }
+        auto print = [&](int exam_id) { AppendRecord(out, *FindByExamId(exam_id)); };
+        if (by_name)
+        {
+            name_index_.ForEachExact(name, print);
+        }
+        else
+        {
+            name_index_.ForEachWithPrefix(name, print);
+        }
+        return nullptr;
+    }
+
+    int exam_id;
+    bool is_delete = MatchVerb(begin, verb_end, "DELETE");
+    if (!is_delete && !MatchVerb(begin, verb_end, "FIND"))
+    {
+        return "未知命令";
+    }
+    if (!ParseIntField(args, end, exam_id))
+    {
+        return "考号必须是数字";
+    }
+    if (is_delete)
+    {
+        return RemoveRecord(exam_id) ? nullptr : "考号不存在";
+    }
+
+    StudentRecord *found = FindByExamId(exam_id);
+    if (found == nullptr)
+    {
+        out.AppendInt(exam_id);
+        out.Append("\t未找到\n");
+        return nullptr;
+    }
+    AppendRecord(out, *found);
+    return nullptr;
+}
+
+void ExamRegistrationSystem::AppendRecord(OutputBuffer &out, const StudentRecord &record)
+{
+    out.AppendInt(record.exam_id);
+    out.Append('\t');
+    out.Append(names_.Get(record.name_offset));
+    out.Append(record.gender == GENDER_MALE ? "\t男\t" : "\t女\t");
+    out.AppendInt(record.age);
+    out.Append('\t');
+    out.Append(categories_.Name(record.category));
+    out.Append('\n');
+}
+
+int ExamRegistrationSystem::RunBatch(const char *path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::cout << "*** 错误: 无法打开命令文件 " << path << " ***" << std::endl;
+        return -1;
+    }
+
+    // 之后的输出绕过 std::cout 直接写标准输出, 先把已有输出刷出去保证顺序
+    std::cout << std::flush;
+    OutputBuffer out(STDOUT_FILENO);
+
+    const char *data = file.Data();
+    const char *data_end = data + file.Size();
+    int executed = 0;
+    int failed = 0;
+    int line_no = 0;
+    long long start = NowMicros();
+    for (const char *line = data; line < data_end;)
+    {
+        const char *newline = (const char *)std::memchr(line, '\n', data_end - line);
+        const char *begin = line;
+        const char *end = newline != nullptr ? newline : data_end;
+        line = end + 1;
+        line_no++;
+        TrimField(begin, end);
+        if (begin == end || *begin == '#')
+        {
+            continue;
+        }
+
+        const char *reason = ExecuteCommand(begin, end, out);
+        executed++;
+        if (reason != nullptr)
+        {
+            out.Append("第 ");
+            out.AppendInt(line_no);
+            out.Append(" 行: ");
+            out.Append(reason);
+            out.Append('\n');
+            failed++;
+        }
+    }
+    bool logged = wal_.Commit();
+    long long elapsed = NowMicros() - start;
+
+    out.Append("*** 批处理执行 ");
+    out.AppendInt(executed);
+    out.Append(" 条命令, 失败 ");
+    out.AppendInt(failed);
+    out.Append(" 条, 现有考生 ");
+    out.AppendInt(count_);
+    out.Append(" 名, 用时 ");
+    out.AppendInt(elapsed / 1000);
+    out.Append(" ms ***\n");
+    out.Flush();
+    return logged ? failed : -1;
+}
+
+// ==================== 快照 ====================
+int ExamRegistrationSystem::SaveSnapshot(const char *path)
+{
+    // 先写临时文件并落盘, 再改名覆盖, 中途崩溃不会留下半个快照
+    const int PATH_SIZE = 512;
+    char temp_path[PATH_SIZE];
+    if (std::strlen(path) + 5 > (unsigned)PATH_SIZE)
+    {
+        return -1;
+    }
+    std::strcpy(temp_path, path);
+    std::strcat(temp_path, ".tmp");
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, FILE_MODE);
+    if (fd < 0)
+    {
+        std::cout << "*** 错误: 无法写入快照 " << temp_path << " ***" << std::endl;
+        return -1;
+    }
+
+    TableStats stats = GetTableStats();
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(Student);
+    header.count = count_;
+    header.engine = engine_;
+    header.bucket_count = stats.bucket_count;
+    header.hash_multiplier = HASH_MULTIPLIER;
+    header.checksum = FNV_OFFSET_BASIS;
+    bool ok = WriteAll(fd, &header, sizeof(header));
+
+    // 记录攒满一批再写, 减少系统调用次数
+    const int BATCH = 4096;
+    Student *batch = new Student[BATCH];
+    int pending = 0;
+    auto append = [&](const StudentRecord &record)
+    {
+        // Unpack 只写到各字符串的 '\0' 为止, 先清零整条记录, 免得把残留的堆内容写进文件
+        std::memset(&batch[pending], 0, sizeof(Student));
+        Unpack(record, batch[pending++]);
+        if (pending == BATCH)
+        {
+            header.checksum = Fnv1a(header.checksum, batch, sizeof(Student) * pending);
+            ok = ok && WriteAll(fd, batch, sizeof(Student) * pending);
+            pending = 0;
+        }
+    };
+    ForEachStudent(append);
+    header.checksum = Fnv1a(header.checksum, batch, sizeof(Student) * pending);
+    ok = ok && WriteAll(fd, batch, sizeof(Student) * pending);
+    delete[] batch;
+
+    // 校验和在写完记录后才知道, 回到文件头重写一次
+    ok = ok && lseek(fd, 0, SEEK_SET) == 0 && WriteAll(fd, &header, sizeof(header));
+
+    ok = ok && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    if (!ok || std::rename(temp_path, path) != 0)
+    {
+        unlink(temp_path);
+        std::cout << "*** 错误: 写入快照 " << path << " 失败 ***" << std::endl;
+        return -1;
+    }
+    return count_;
+}
+
+int ExamRegistrationSystem::LoadSnapshot(const char *path)
+{
+    MappedFile file;
+    errno = 0;
+    if (!file.Open(path))
+    {
+        if (errno == ENOENT)
+        {
+            return 0;
+        }
+        // 文件存在却读不出来(无权限、无法映射等)时不能当作空快照, 否则退出时会覆盖原有名单
+        std::cout << "*** 错误: 无法读取快照 " << path << " ***" << std::endl;
+        return -1;
+    }
+
+    SnapshotHeader header;
+    if (file.Size() < (long)sizeof(header))
+    {
+        std::cout << "*** 错误: 快照 " << path << " 已损坏 ***" << std::endl;
+        return -1;
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != (int)sizeof(Student) || header.count < 0 ||
+        file.Size() != (long)sizeof(header) + (long)header.count * (long)sizeof(Student))
+    {
+        std::cout << "*** 错误: 快照 " << path << " 格式不符 ***" << std::endl;
+        return -1;
+    }
+
+    // 映射首地址按页对齐, 文件头长度是 Student 对齐的整数倍, 可直接按数组访问
+    const Student *records = (const Student *)(file.Data() + sizeof(header));
+
+    // 先整体校验再插入: 校验和不符、任何一条记录不合法、考号重复或类别种数超出上限都放弃整个快照
+    bool valid = Fnv1a(FNV_OFFSET_BASIS, records, (long)header.count * (long)sizeof(Student)) == header.checksum;
+    unsigned char *seen = new unsigned char[MAX_EXAM_ID / 8 + 1];
+    std::memset(seen, 0, MAX_EXAM_ID / 8 + 1);
+    CategoryDictionary new_categories;
+    for (int i = 0; valid && i < header.count; ++i)
+    {
+        const Student &stu = records[i];
+        int id = stu.exam_id;
+        valid = ValidateRecord(stu) && (seen[id >> 3] & (1 << (id & 7))) == 0 && !ExamIdExists(id);
+        if (valid)
+        {
+            seen[id >> 3] |= (unsigned char)(1 << (id & 7));
+            if (categories_.Find(stu.category) < 0)
+            {
+                valid = new_categories.Intern(stu.category) >= 0 &&
+                        categories_.Size() + new_categories.Size() <= CategoryDictionary::MAX_CATEGORIES;
+            }
+        }
+    }
+    delete[] seen;
+    if (!valid)
+    {
+        std::cout << "*** 错误: 快照 " << path << " 格式不符 ***" << std::endl;
+        return -1;
+    }
+
+    Reserve(count_ + header.count);
+    for (int i = 0; i < header.count; ++i)
+    {
+        InsertRecord(records[i]);
+    }
+    return header.count;
+}
+
+// ==================== 预写日志 ====================
+void ExamRegistrationSystem::LogMutation(int op, int exam_id, const Student *record)
+{
+    if (!wal_.IsOpen())
+    {
+        return;
+    }
+    wal_.Append(op, exam_id, record);
+    if (snapshot_path_ != nullptr && wal_.Size() >= compact_bytes_)
+    {
+        CompactLog();
+    }
+}
+
+bool ExamRegistrationSystem::CompactLog()
+{
+    // 先提交日志再写快照, 快照落盘后才截断日志;
+    // 中途崩溃时重放的是快照已包含的修改, 重放按"最后一次操作为准"处理, 结果不变。
+    // 日志提交失败时缓冲区仍保留, 快照写成功则修改已经落盘, 缓冲区随日志一起清空
+    bool committed = wal_.Commit();
+    if (SaveSnapshot(snapshot_path_) < 0)
+    {
+        return committed;
+    }
+    wal_.Reset();
+    return true;
+}
+
+int ExamRegistrationSystem::ReplayLog(const char *path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        return 0;
+    }
+
+    const char *data = file.Data();
+    long size = file.Size();
+    long offset = 0;
+    int replayed = 0;
+    while (offset + (long)sizeof(WalEntryHeader) <= size)
+    {
+        WalEntryHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        bool has_record = header.op == WAL_INSERT || header.op == WAL_MODIFY;
+        long length = sizeof(header) + (has_record ? sizeof(Student) : 0);
+        if (offset + length > size || (!has_record && header.op != WAL_DELETE))
+        {
+            break;
+        }
+
+        Student record;
+        if (has_record)
+        {
+            std::memcpy(&record, data + offset + sizeof(header), sizeof(record));
+        }
+        if (WalChecksum(header, has_record ? &record : nullptr) != header.checksum)
+        {
+            break;
+        }
+        // 校验和只说明记录没写坏, 字段仍按快照载入的规则检查, 不合法的记录与其后的内容一并丢弃
+        if (has_record && (record.exam_id != header.exam_id || !ValidateRecord(record) ||
+                           !ValidateCategory(record.category)))
+        {
+            break;
+        }
+
+        // 插入与修改都按覆盖处理, 使日志可以重复重放
+        StudentRecord *found = FindByExamId(header.exam_id);
+        if (!has_record)
+        {
+            RemoveRecord(header.exam_id);
+        }
+        else if (found != nullptr)
+        {
+            UpdateRecord(found, record);
+        }
+        else
+        {
+            InsertRecord(record);
+        }
+        offset += length;
+        replayed++;
+    }
+
+    // 尾部是崩溃时写了一半或不合法的记录, 截掉以免之后的追加接在坏数据后面
+    if (offset < size)
+    {
+        std::cout << "*** 警告: 日志 " << path << " 尾部 " << (size - offset)
+                  << " 字节不完整或不合法, 已丢弃 ***" << std::endl;
+        file.Close();
+        truncate(path, offset);
+    }
+    return replayed;
+}
+
+bool ExamRegistrationSystem::OpenLog(const char *path, const char *snapshot_path,
+                                     int batch_size, int interval_ms, long compact_bytes)
+{
+    if (!wal_.Open(path, batch_size, interval_ms))
+    {
+        std::cout << "*** 错误: 无法打开日志 " << path << " ***" << std::endl;
+        return false;
+    }
+    snapshot_path_ = snapshot_path;
+    compact_bytes_ = compact_bytes;
+    return true;
+}
+
+bool ExamRegistrationSystem::CloseLog()
+{
+    if (!wal_.IsOpen())
+    {
+        return true;
+    }
+    if (snapshot_path_ != nullptr)
+    {
+        CompactLog();
+    }
+    // 压缩失败时缓冲区保留, 关闭前再提交一次
+    return wal_.Close();
+}
+
+void ExamRegistrationSystem::Insert()
+{
+    PrintTitle("插入考生信息");
+
+    std::cout << "\n请输入要插入的考生信息:" << std::endl;
+    Student stu;
+
+    if (InputStudent(stu, true))
+    {
+        InsertRecord(stu);
+        std::cout << "\n>>> 考生信息插入成功! <<<" << std::endl;
+        PrintAll();
+    }
+}
+
+void ExamRegistrationSystem::InsertRecord(const Student &stu)
+{
+    StudentRecord record;
+    Pack(stu, record);
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        open_table_.Insert(record.exam_id, record);
+    }
+    else
+    {
+        chained_table_.Insert(record.exam_id, record);
+    }
+    index_.Add(record);
+    ordered_ids_.Insert(record.exam_id);
+    name_index_.Add(stu.name, record.exam_id);
+    count_++;
+    LogMutation(WAL_INSERT, stu.exam_id, &stu);
+}
+
+bool ExamRegistrationSystem::RemoveRecord(int exam_id)
+{
+    StudentRecord removed;
+    bool erased = (engine_ == OPEN_ADDRESSING_ENGINE)
+                      ? open_table_.Erase(exam_id, &removed)
+                      : chained_table_.Erase(exam_id, &removed);
+    if (!erased)
+    {
+        return false;
+    }
+    index_.Remove(removed);
+    ordered_ids_.Erase(exam_id);
+    name_index_.Remove(names_.Get(removed.name_offset), exam_id);
+    names_.Release(removed.name_offset);
+    count_--;
+    LogMutation(WAL_DELETE, exam_id, nullptr);
+    CompactNames();
+    return true;
+}
+
+void ExamRegistrationSystem::UpdateRecord(StudentRecord *found, const Student &stu)
+{
+    // 同步二级索引; 新姓名追加到姓名区, 旧姓名留待压缩
+    index_.Remove(*found);
+    name_index_.Remove(names_.Get(found->name_offset), found->exam_id);
+    names_.Release(found->name_offset);
+    Pack(stu, *found);
+    index_.Add(*found);
+    name_index_.Add(stu.name, found->exam_id);
+    LogMutation(WAL_MODIFY, stu.exam_id, &stu);
+    CompactNames();
+}
+
+void ExamRegistrationSystem::FindBatch(const int *exam_ids, int n, StudentRecord **results)
+{
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        open_table_.FindBatch(exam_ids, n, results);
+    }
+    else
+    {
+        chained_table_.FindBatch(exam_ids, n, results);
+    }
+}
+
+void ExamRegistrationSystem::Reserve(int n)
+{
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        open_table_.Reserve(n);
+    }
+    else
+    {
+        chained_table_.Reserve(n);
+    }
+}
+
+StudentRecord *ExamRegistrationSystem::FindByExamId(int exam_id)
+{
+    if (engine_ == OPEN_ADDRESSING_ENGINE)
+    {
+        return open_table_.Find(exam_id);
+    }
+    return chained_table_.Find(exam_id);
+}
+
+bool ExamRegistrationSystem::DeleteByExamId(int exam_id)
+{
+    StudentRecord *found = FindByExamId(exam_id);
+    if (found == nullptr)
+    {
+        return false;
+    }
+
+    std::cout << "\n你删除的考生信息是:" << std::endl;
+    PrintHeader();
+    PrintStudent(*found);
+    PrintSeparator('-');
+    RemoveRecord(exam_id);
+    return true;
+}
+
+void ExamRegistrationSystem::Delete()
+{
+    PrintTitle("删除考生信息");
+
+    if (count_ == 0)
+    {
+        std::cout << "\n*** 当前系统中暂无考生信息! ***\n"
+                  << std::endl;
+        return;
+    }
+
+    int exam_id;
+    while (true)
+    {
+        std::cout << "请输入要删除的考生考号: ";
+        if (!(std::cin >> exam_id))
+        {
+            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+        break;
+    }
+
+    if (DeleteByExamId(exam_id))
+    {
+        std::cout << ">>> 考生信息删除成功! <<<" << std::endl;
+        PrintAll();
+    }
+    else
+    {
+        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
+                  << std::endl;
+    }
+}
+
+void ExamRegistrationSystem::Search()
+{
+    PrintTitle("查找考生信息");
+
+    int exam_id;
+    while (true)
+    {
+        std::cout << "请输入要查找的考生考号: ";
+        if (!(std::cin >> exam_id))
+        {
+            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+        break;
+    }
+
+    StudentRecord *found = FindByExamId(exam_id);
+    if (found != nullptr)
+    {
+        std::cout << "\n查找结果:" << std::endl;
+        PrintHeader();
+        PrintStudent(*found);
+        PrintSeparator('-');
+    }
+    else
+    {
+        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
+                  << std::endl;
+    }
+}
+
+void ExamRegistrationSystem::Modify()
+{
+    PrintTitle("修改考生信息");
+
+    int exam_id;
+    while (true)
+    {
+        std::cout << "请输入要修改的考生考号: ";
+        if (!(std::cin >> exam_id))
+        {
+            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+        break;
+    }
+
+    StudentRecord *found = FindByExamId(exam_id);
+    if (found != nullptr)
+    {
+        std::cout << "\n当前考生信息:" << std::endl;
+        PrintHeader();
+        PrintStudent(*found);
+        PrintSeparator('-');
+
+        std::cout << "\n请输入修改后的信息 (考号不可修改):" << std::endl;
+
+        Student temp_stu;
+        temp_stu.exam_id = found->exam_id; // 保持考号不变
+
+        // 输入姓名
+        while (true)
+        {
+            std::cout << "姓名: ";
+            std::cin >> temp_stu.name;
+
+            int name_len = std::strlen(temp_stu.name);
+            if (name_len == 0 || name_len >= 50)
+            {
+                std::cout << "*** 错误: 姓名长度必须在 1-49 个字符之间! ***" << std::endl;
+                continue;
+            }
+            break;
+        }
+
+        // 输入性别
+        while (true)
+        {
+            std::cout << "性别(男/女): ";
+            std::cin >> temp_stu.gender;
+
+            if (!ValidateGender(temp_stu.gender))
+            {
+                std::cout << "*** 错误: 性别只能输入'男'或'女'! ***" << std::endl;
+                continue;
+            }
+            break;
+        }
+
+        // 输入年龄
+        while (true)
+        {
+            std::cout << "年龄: ";
+            if (!(std::cin >> temp_stu.age))
+            {
+                std::cout << "*** 错误: 年龄必须是数字! ***" << std::endl;
+                ClearInputBuffer();
+                continue;
+            }
+
+            if (!ValidateAge(temp_stu.age))
+            {
+                std::cout << "*** 错误: 年龄必须在 10-100 之间! ***" << std::endl;
+                continue;
+            }
+            break;
+        }
+
+        // 输入报考类别
+        while (true)
+        {
+            std::cout << "报考类别: ";
+            std::cin >> temp_stu.category;
+
+            int category_len = std::strlen(temp_stu.category);
+            if (category_len == 0 || category_len >= 50)
+            {
+                std::cout << "*** 错误: 报考类别长度必须在 1-49 个字符之间! ***" << std::endl;
+                continue;
+            }
+            if (!ValidateCategory(temp_stu.category))
+            {
+                std::cout << "*** 错误: 报考类别种数已达上限! ***" << std::endl;
+                continue;
+            }
+            break;
+        }
+
+        // 更新信息
+        UpdateRecord(found, temp_stu);
+
+        std::cout << "\n>>> 考生信息修改成功! <<<" << std::endl;
+        PrintAll();
+    }
+    else
+    {
+        std::cout << "\n*** 错误: 未找到考号为 " << exam_id << " 的考生! ***\n"
+                  << std::endl;
+    }
+}
+
+void ExamRegistrationSystem::Statistics()
+{
+    PrintTitle("统计考生信息");
+    PrintAll();
+
+    TableStats stats = GetTableStats();
+    std::cout << "哈希表: " << (engine_ == OPEN_ADDRESSING_ENGINE ? "开放定址" : "拉链法")
+              << ", 桶数 " << stats.bucket_count
+              << ", 装载因子 " << stats.load_factor
+              << ", 最长链 " << stats.max_chain_length
+              << (stats.rehashing ? " (再散列进行中)" : "") << std::endl;
+
+    if (count_ == 0)
+    {
+        return;
+    }
+
+    // 以下汇总均来自二级索引, 不扫描哈希表
+    std::cout << "记录: 每人 " << sizeof(StudentRecord) << " 字节, 姓名区 " << names_.Size()
+              << " 字节(待回收 " << names_.GarbageBytes() << "), 类别字典 "
+              << categories_.Size() << " 项" << std::endl;
+
+    std::cout << "\n性别统计: 男 " << index_.CountByGender(GENDER_MALE)
+              << " 人, 女 " << index_.CountByGender(GENDER_FEMALE) << " 人" << std::endl;
+
+    std::cout << "\n报考类别统计:" << std::endl;
+    auto print_category = [this](int category, int count)
+    {
+        std::cout << "  " << categories_.Name(category) << "\t" << count << " 人" << std::endl;
+    };
+    index_.ForEachCategory(print_category);
+
+    std::cout << "\n年龄分布:" << std::endl;
+    for (int low = MIN_AGE; low <= MAX_AGE; low += 10)
+    {
+        int high = low + 9 < MAX_AGE ? low + 9 : MAX_AGE;
+        int count = index_.CountByAgeRange(low, high);
+        if (count > 0)
+        {
+            std::cout << "  " << low << "-" << high << " 岁\t" << count << " 人" << std::endl;
+        }
+    }
+}
+
+void ExamRegistrationSystem::QueryByCategory()
+{
+    PrintTitle("按报考类别查询");
+
+    char category[50];
+    std::cout << "请输入报考类别: ";
+    std::cin >> category;
+
+    int count = index_.CountByCategory(categories_.Find(category));
+    if (count == 0)
+    {
+        std::cout << "\n*** 报考类别 " << category << " 下暂无考生! ***\n"
+                  << std::endl;
+        return;
+    }
+
+    std::cout << std::endl;
+    PrintHeader();
+    auto print = [this](int exam_id) { PrintStudent(*FindByExamId(exam_id)); };
+    index_.ForEachInCategory(categories_.Find(category), print);
+    PrintSeparator('-');
+    std::cout << "报考类别 " << category << " 共 " << count << " 名考生" << std::endl;
+}
+
+void ExamRegistrationSystem::QueryByAgeRange()
+{
+    PrintTitle("按年龄区间查询");
+
+    int min_age;
+    int max_age;
+    while (true)
+    {
+        std::cout << "请输入年龄下限和上限: ";
+        if (!(std::cin >> min_age >> max_age))
+        {
+            std::cout << "*** 错误: 年龄必须是数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+        if (min_age > max_age)
+        {
+            std::cout << "*** 错误: 下限不能大于上限! ***" << std::endl;
+            continue;
+        }
+        break;
+    }
+
+    int count = index_.CountByAgeRange(min_age, max_age);
+    if (count == 0)
+    {
+        std::cout << "\n*** 年龄在 " << min_age << "-" << max_age << " 之间的考生暂无! ***\n"
+                  << std::endl;
+        return;
+    }
+
+    std::cout << std::endl;
+    PrintHeader();
+    auto print = [this](int exam_id) { PrintStudent(*FindByExamId(exam_id)); };
+    index_.ForEachInAgeRange(min_age, max_age, print);
+    PrintSeparator('-');
+    std::cout << "年龄在 " << min_age << "-" << max_age << " 之间共 " << count << " 名考生" << std::endl;
+}
+
+void ExamRegistrationSystem::QueryByExamIdRange()
+{
+    PrintTitle("按考号区间查询");
+
+    int low;
+    int high;
+    while (true)
+    {
+        std::cout << "请输入考号下限和上限: ";
+        if (!(std::cin >> low >> high))
+        {
+            std::cout << "*** 错误: 考号必须是数字! ***" << std::endl;
+            ClearInputBuffer();
+            continue;
+        }
+        if (low > high)
+        {
+            std::cout << "*** 错误: 下限不能大于上限! ***" << std::endl;
+            continue;
+        }
+        break;
+    }
+
+    int count = 0;
+    auto print = [&](const StudentRecord &record)
+    {
+        if (count++ == 0)
+        {
+            std::cout << std::endl;
+            PrintHeader();
+        }
+        PrintStudent(record);
+    };
+    ForEachStudentInRange(low, high, print);
+    if (count == 0)
+    {
+        std::cout << "\n*** 考号在 " << low << "-" << high << " 之间的考生暂无! ***\n"
+                  << std::endl;
+        return;
+    }
+    PrintSeparator('-');
+    std::cout << "考号在 " << low << "-" << high << " 之间共 " << count << " 名考生" << std::endl;
+}
+
+void ExamRegistrationSystem::QueryByName()
+{
+    PrintTitle("按姓名查询");
+
+    char name[50];
+    std::cout << "请输入姓名(以 * 结尾表示按前缀查询): ";
+    std::cin >> name;
+
+    int length = std::strlen(name);
+    bool by_prefix = length > 0 && name[length - 1] == '*';
+    if (by_prefix)
+    {
+        name[length - 1] = '\0';
+    }
+
+    int count = 0;
+    auto print = [&](int exam_id)
+    {
+        if (count++ == 0)
+        {
+            std::cout << std::endl;
+            PrintHeader();
+        }
+        PrintStudent(*FindByExamId(exam_id));
+    };
+    if (by_prefix)
+    {
+        name_index_.ForEachWithPrefix(name, print);
+    }
+    else
+    {
+        name_index_.ForEachExact(name, print);
+    }
+
+    if (count == 0)
+    {
+        std::cout << "\n*** 未找到" << (by_prefix ? "姓名以 " : "姓名为 ") << name
+                  << (by_prefix ? " 开头的考生! ***\n" : " 的考生! ***\n")
+                  << std::endl;
+        return;
+    }
+    PrintSeparator('-');
+    std::cout << "共 " << count << " 名考生" << std::endl;
+}
+
+void ExamRegistrationSystem::Run()
+{
+    if (count_ == 0)
+    {
+        Initialize();
+    }
+
+    char choice;
+    while (true)
+    {
+        // 等待输入前提交已缓冲的日志
+        wal_.Commit();
+
+        ShowMenu();
+        std::cout << "请选择操作 [0-9]: ";
+        std::cin >> choice;
+
+        switch (choice)
+        {
+        case '1':
+            Insert();
+            break;
+        case '2':
+            Delete();
+            break;
+        case '3':
+            Search();
+            break;
+        case '4':
+            Modify();
+            break;
+        case '5':
+            Statistics();
+            break;
+        case '6':
+            QueryByCategory();
+            break;
+        case '7':
+            QueryByAgeRange();
+            break;
+        case '8':
+            QueryByExamIdRange();
+            break;
+        case '9':
+            QueryByName();
+            break;
+        case '0':
+            PrintSeparator('=');
+            std::cout << "\n感谢使用考生报名系统! 再见!\n"
+                      << std::endl;
+            PrintSeparator('=');
+            return;
+        default:
+            std::cout << "\n*** 错误: 无效的操作! 请输入 0-9 之间的数字。***\n"
+                      << std::endl;
+            ClearInputBuffer();
+            break;
+        }
+    }
+}
+// ==================== 并发分片哈希表 ====================
+// 多个报名点同时录入/查询时使用。考号按散列分到若干分片, 每个分片一把自旋锁
+// (锁分段), 写操作只锁所在分片; 查找不加锁, 用分片的版本号(seqlock)做乐观读:
+// 读前读后版本号一致且为偶数才算读到一致的结果, 否则重试, 多次失败后再加锁读。
+// 乐观读可能访问到正被修改的结点, 因此结点只在结点池内复用、退役的桶数组
+// 保留到析构时才释放, 保证读到的地址始终有效。
+//
+// 只读视图(快照)按纪元做多版本: 每个结点记录生效纪元 born 与失效纪元 died,
+// 写操作在分片锁内读取当前纪元作为时间戳; 取快照时把全局纪元加一,
+// 快照 S 只看 born <= S < died 的版本。有快照在扫描时, 删除只标记 died、
+// 修改写成新版本(写时复制), 旧版本留在链上供快照读取;
+// 没有快照时写操作原地修改, 并顺带清扫分片内积压的旧版本。
+class ConcurrentRegistry
+{
+public:
+    explicit ConcurrentRegistry(int shard_count = DEFAULT_SHARDS);
+    ~ConcurrentRegistry();
+
+    // 插入考生, 考号已存在时返回 false
+    bool Insert(const Student &stu);
+
+    // 按考号修改, 考号不存在时返回 false
+    bool Update(const Student &stu);
+
+    // 按考号删除
+    bool Erase(int exam_id);
+
+    // 按考号查找, 找到时把记录拷贝到 out
+    bool Find(int exam_id, Student *out);
+
+    int Size();
+
+    // 取一份一致的快照并逐个访问其中的考生, 返回快照中的考生数。
+    // 各分片依次在锁内把可见版本拷出后立即解锁, visit 在锁外调用,
+    // 因此扫描期间其他线程的增删改只在拷贝单个分片时短暂等待
+    template <typename Visitor>
+    int ScanSnapshot(Visitor &visit);
+
+    static const int DEFAULT_SHARDS = 64;
+
+private:
+    static const int MAX_OPTIMISTIC_TRIES = 4;
+    static const unsigned long long LIVE_EPOCH = ~0ULL; // died 取此值表示当前版本
+
+    // 一条记录的一个版本
+    struct Node
+    {
+        Student data;
+        unsigned long long born; // 生效纪元
+        unsigned long long died; // 失效纪元, 仍有效时为 LIVE_EPOCH
+        Node *next;
+    };
+
+    // 桶数组与桶数放在一起, 读者取一次指针即可得到一致的 (桶数, 桶) 组合
+    struct BucketArray
+    {
+        int count;
+        int prime_level;
+        Node **heads;
+        BucketArray *retired_next; // 退役后串成链表, 析构时统一释放
+    };
+
+    struct Shard
+    {
+        unsigned int seq;       // 版本号, 奇数表示写入中
+        int lock;               // 自旋锁, 0 空闲 1 占用
+        BucketArray *buckets;
+        int size;               // 有效记录数(不含旧版本)
+        int stale;              // 链上已失效、等待清扫的旧版本数
+        BucketArray *retired;   // 退役的桶数组
+        NodePool<Node> pool;
+        char padding[64];       // 避免相邻分片的锁落在同一缓存行
+    };
+
+    Shard *shards_;
+    int shard_count_;
+    unsigned long long epoch_; // 全局纪元, 每取一次快照加一
+    int active_snapshots_;     // 正在扫描的快照数
+
+    static unsigned int Hash(int exam_id);
+    static BucketArray *NewBuckets(int prime_level);
+    Shard &ShardFor(unsigned int hash) { return shards_[hash % shard_count_]; }
+
+    static void Lock(Shard &shard);
+    static void Unlock(Shard &shard);
+    static void BeginWrite(Shard &shard);
+    static void EndWrite(Shard &shard);
+
+    // 在持有锁的情况下查找当前版本
+    static Node *FindLocked(Shard &shard, int exam_id, unsigned int hash);
+
+    // 在持有锁的情况下取写操作的时间戳; 返回旧版本是否须保留给快照
+    bool StampLocked(Shard &shard, unsigned long long *epoch);
+
+    // 在持有锁且没有快照时摘除分片内全部旧版本
+    static void SweepLocked(Shard &shard);
+
+    // 在持有锁的情况下把新结点挂到桶头
+    static void LinkLocked(Shard &shard, Node *node, unsigned int hash);
+
+    // 在持有锁的情况下扩容
+    static void Grow(Shard &shard);
+};
+
+template <typename Visitor>
+int ConcurrentRegistry::ScanSnapshot(Visitor &visit)
+{
+    // 先登记再推进纪元: 写者先读纪元再读登记数, 读到 0 时其时间戳必不晚于本快照,
+    // 被它覆盖的旧版本本快照也看不到, 可以放心原地修改
+    __atomic_add_fetch(&active_snapshots_, 1, __ATOMIC_SEQ_CST);
+    unsigned long long snapshot = __atomic_fetch_add(&epoch_, 1, __ATOMIC_SEQ_CST);
+
+    int capacity = 0;
+    Student *buffer = nullptr;
+    int total = 0;
+    for (int i = 0; i < shard_count_; ++i)
+    {
+        Shard &shard = shards_[i];
+        Lock(shard);
+        if (shard.size + shard.stale > capacity)
+        {
+            delete[] buffer;
+            capacity = (shard.size + shard.stale) * 2;
+            buffer = new Student[capacity];
+        }
+        int count = 0;
+        BucketArray *array = shard.buckets;
+        for (int b = 0; b < array->count; ++b)
+        {
+            for (Node *node = array->heads[b]; node != nullptr; node = node->next)
+            {
+                // 快照可见的版本每个考号至多一个, 总数不超过分片的版本数
+                if (node->born <= snapshot && snapshot < node->died)
+                {
+                    buffer[count++] = node->data;
+                }
+            }
+        }
+        Unlock(shard);
+
+        for (int k = 0; k < count; ++k)
+        {
+            visit(buffer[k]);
+        }
+        total += count;
+    }
+    delete[] buffer;
+
+    __atomic_sub_fetch(&active_snapshots_, 1, __ATOMIC_SEQ_CST);
+    return total;
+}
+
+ConcurrentRegistry::ConcurrentRegistry(int shard_count)
+    : shard_count_(shard_count > 0 ? shard_count : 1), epoch_(0), active_snapshots_(0)
+{
+    shards_ = new Shard[shard_count_];
+    for (int i = 0; i < shard_count_; ++i)
+    {
+        shards_[i].seq = 0;
+        shards_[i].lock = 0;
+        shards_[i].buckets = NewBuckets(0);
+        shards_[i].size = 0;
+        shards_[i].stale = 0;
+        shards_[i].retired = nullptr;
+    }
+}
+
+ConcurrentRegistry::~ConcurrentRegistry()
+{
+    for (int i = 0; i < shard_count_; ++i)
+    {
+        shards_[i].buckets->retired_next = shards_[i].retired;
+        BucketArray *array = shards_[i].buckets;
+        while (array != nullptr)
+        {
+            BucketArray *next = array->retired_next;
+            delete[] array->heads;
+            delete array;
+            array = next;
+        }
+    }
+    delete[] shards_;
+}
+
+unsigned int ConcurrentRegistry::Hash(int exam_id)
+{
+    unsigned long long hash = HASH_MULTIPLIER * (unsigned int)exam_id;
+    return (unsigned int)(hash >> 16);
+}
+
+ConcurrentRegistry::BucketArray *ConcurrentRegistry::NewBuckets(int prime_level)
+{
+    BucketArray *array = new BucketArray;
+    array->count = BUCKET_PRIMES[prime_level];
+    array->prime_level = prime_level;
+    array->heads = new Node *[array->count]();
+    array->retired_next = nullptr;
+    return array;
+}
+
+void ConcurrentRegistry::Lock(Shard &shard)
+{
+    // 先只读等待, 锁可能空闲时再尝试交换, 减少缓存行争抢;
+    // 久等不到时让出 CPU, 避免持锁线程被抢占后其他线程空转整个时间片
+    const int SPINS_BEFORE_YIELD = 128;
+    while (__atomic_exchange_n(&shard.lock, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        for (int spins = 0; __atomic_load_n(&shard.lock, __ATOMIC_RELAXED) != 0; ++spins)
+        {
+            if (spins >= SPINS_BEFORE_YIELD)
+            {
+                sched_yield();
+                spins = 0;
+            }
+        }
+    }
+}
+
+void ConcurrentRegistry::Unlock(Shard &shard)
+{
+    __atomic_store_n(&shard.lock, 0, __ATOMIC_RELEASE);
+}
+
+void ConcurrentRegistry::BeginWrite(Shard &shard)
+{
+    __atomic_store_n(&shard.seq, shard.seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void ConcurrentRegistry::EndWrite(Shard &shard)
+{
+    __atomic_store_n(&shard.seq, shard.seq + 1, __ATOMIC_RELEASE);
+}
+
+ConcurrentRegistry::Node *ConcurrentRegistry::FindLocked(Shard &shard, int exam_id, unsigned int hash)
+{
+    BucketArray *array = shard.buckets;
+    for (Node *node = array->heads[hash % array->count]; node != nullptr; node = node->next)
+    {
+        if (node->data.exam_id == exam_id && node->died == LIVE_EPOCH)
+        {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+bool ConcurrentRegistry::StampLocked(Shard &shard, unsigned long long *epoch)
+{
+    // 必须先读纪元再读快照数, 见 ScanSnapshot
+    *epoch = __atomic_load_n(&epoch_, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&active_snapshots_, __ATOMIC_SEQ_CST) > 0)
+    {
+        return true;
+    }
+    if (shard.stale > 0)
+    {
+        SweepLocked(shard);
+    }
+    return false;
+}
+
+void ConcurrentRegistry::SweepLocked(Shard &shard)
+{
+    // 清扫在写区间内进行, 期间的乐观读都会重试
+    BeginWrite(shard);
+    BucketArray *array = shard.buckets;
+    for (int i = 0; i < array->count && shard.stale > 0; ++i)
+    {
+        Node **link = &array->heads[i];
+        while (*link != nullptr)
+        {
+            Node *node = *link;
+            if (node->died != LIVE_EPOCH)
+            {
+                __atomic_store_n(link, node->next, __ATOMIC_RELAXED);
+                shard.pool.Free(node);
+                shard.stale--;
+            }
+            else
+            {
+                link = &node->next;
+            }
+        }
+    }
+    EndWrite(shard);
+}
+
+void ConcurrentRegistry::LinkLocked(Shard &shard, Node *node, unsigned int hash)
+{
+    if (shard.size + shard.stale >= shard.buckets->count && shard.buckets->prime_level + 1 < BUCKET_PRIME_COUNT)
+    {
+        Grow(shard);
+    }
+    Node **head = &shard.buckets->heads[hash % shard.buckets->count];
+    node->next = *head;
+    __atomic_store_n(head, node, __ATOMIC_RELEASE);
+}
+
+void ConcurrentRegistry::Grow(Shard &shard)
+{
+    BucketArray *old_array = shard.buckets;
+    BucketArray *new_array = NewBuckets(old_array->prime_level + 1);
+
+    // 扩容发生在写区间内, 期间的乐观读都会因版本号变化而重试
+    for (int i = 0; i < old_array->count; ++i)
+    {
+        Node *node = old_array->heads[i];
+        while (node != nullptr)
+        {
+            Node *next = node->next;
+            int index = Hash(node->data.exam_id) % new_array->count;
+            __atomic_store_n(&node->next, new_array->heads[index], __ATOMIC_RELAXED);
+            new_array->heads[index] = node;
+            node = next;
+        }
+    }
+    __atomic_store_n(&shard.buckets, new_array, __ATOMIC_RELEASE);
+
+    // 旧桶数组可能仍被读者引用, 退役到析构时再释放
+    old_array->retired_next = shard.retired;
+    shard.retired = old_array;
+}
+
+bool ConcurrentRegistry::Insert(const Student &stu)
+{
+    unsigned int hash = Hash(stu.exam_id);
+    Shard &shard = ShardFor(hash);
+    Lock(shard);
+    if (FindLocked(shard, stu.exam_id, hash) != nullptr)
+    {
+        Unlock(shard);
+        return false;
+    }
+
+    unsigned long long epoch;
+    StampLocked(shard, &epoch);
+    BeginWrite(shard);
+    Node *node = shard.pool.Allocate();
+    node->data = stu;
+    node->born = epoch;
+    node->died = LIVE_EPOCH;
+    LinkLocked(shard, node, hash);
+    shard.size++;
+    EndWrite(shard);
+
+    Unlock(shard);
+    return true;
+}
+
+bool ConcurrentRegistry::Update(const Student &stu)
+{
+    unsigned int hash = Hash(stu.exam_id);
+    Shard &shard = ShardFor(hash);
+    Lock(shard);
+
+    unsigned long long epoch;
+    bool keep_old = StampLocked(shard, &epoch);
+    Node *node = FindLocked(shard, stu.exam_id, hash);
+    if (node != nullptr)
+    {
+        BeginWrite(shard);
+        if (keep_old)
+        {
+            // 写时复制: 新版本挂到桶头, 旧版本留给正在扫描的快照
+            Node *version = shard.pool.Allocate();
+            version->data = stu;
+            version->born = epoch;
+            version->died = LIVE_EPOCH;
+            __atomic_store_n(&node->died, epoch, __ATOMIC_RELAXED);
+            shard.stale++;
+            LinkLocked(shard, version, hash);
+        }
+        else
+        {
+            node->data = stu;
+        }
+        EndWrite(shard);
+    }
+
+    Unlock(shard);
+    return node != nullptr;
+}
+
+bool ConcurrentRegistry::Erase(int exam_id)
+{
+    unsigned int hash = Hash(exam_id);
+    Shard &shard = ShardFor(hash);
+    Lock(shard);
+
+    unsigned long long epoch;
+    bool keep_old = StampLocked(shard, &epoch);
+    Node **link = &shard.buckets->heads[hash % shard.buckets->count];
+    while (*link != nullptr && ((*link)->data.exam_id != exam_id || (*link)->died != LIVE_EPOCH))
+    {
+        link = &(*link)->next;
+    }
+    bool erased = *link != nullptr;
+    if (erased)
+    {
+        BeginWrite(shard);
+        Node *node = *link;
+        if (keep_old)
+        {
+            // 只标记失效, 快照仍可读到删除前的记录
+            __atomic_store_n(&node->died, epoch, __ATOMIC_RELAXED);
+            shard.stale++;
+        }
+        else
+        {
+            __atomic_store_n(link, node->next, __ATOMIC_RELAXED);
+            shard.pool.Free(node);
+        }
+        shard.size--;
+        EndWrite(shard);
+    }
+
+    Unlock(shard);
+    return erased;
+}
+
+bool ConcurrentRegistry::Find(int exam_id, Student *out)
+{
+    unsigned int hash = Hash(exam_id);
+    Shard &shard = ShardFor(hash);
+
+    for (int attempt = 0; attempt < MAX_OPTIMISTIC_TRIES; ++attempt)
+    {
+        unsigned int begin_seq = __atomic_load_n(&shard.seq, __ATOMIC_ACQUIRE);
+        if (begin_seq & 1)
+        {
+            continue;
+        }
+
+        // 并发修改可能让读者看到的链表暂时成环, 步数超过链上结点总数即视为读失败
+        int max_steps = __atomic_load_n(&shard.size, __ATOMIC_RELAXED) +
+                        __atomic_load_n(&shard.stale, __ATOMIC_RELAXED) + 1;
+        BucketArray *array = __atomic_load_n(&shard.buckets, __ATOMIC_ACQUIRE);
+        Node *node = __atomic_load_n(&array->heads[hash % array->count], __ATOMIC_ACQUIRE);
+        bool found = false;
+        int steps = 0;
+        for (; node != nullptr && steps < max_steps; ++steps)
+        {
+            if (__atomic_load_n(&node->data.exam_id, __ATOMIC_RELAXED) == exam_id &&
+                __atomic_load_n(&node->died, __ATOMIC_RELAXED) == LIVE_EPOCH)
+            {
+                std::memcpy(out, &node->data, sizeof(Student));
+                found = true;
+                break;
+            }
+            node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (steps < max_steps && __atomic_load_n(&shard.seq, __ATOMIC_RELAXED) == begin_seq)
+        {
+            return found;
+        }
+    }
+
+    // 写入频繁时退化为加锁读
+    Lock(shard);
+    Node *node = FindLocked(shard, exam_id, hash);
+    if (node != nullptr)
+    {
+        *out = node->data;
+    }
+    Unlock(shard);
+    return node != nullptr;
+}
+
+int ConcurrentRegistry::Size()
+{
+    int size = 0;
+    for (int i = 0; i < shard_count_; ++i)
+    {
+        size += __atomic_load_n(&shards_[i].size, __ATOMIC_RELAXED);
+    }
+    return size;
+}
+
+// ==================== 并发压测 ====================
+// 预先写入一批考生, 然后分别用 1, 2, 4, ... 个线程做读写混合操作,
+// 对比全局一把锁(1 个分片)与锁分段(64 个分片)的吞吐量。
+struct ConcurrentBenchTask
+{
+    ConcurrentRegistry *registry;
+    int ops;
+    int read_percent;
+    int key_range;
+    unsigned int seed;
+    long long hits;
+};
+
+static unsigned int NextRandom(unsigned int &state)
+{
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void FillBenchStudent(Student &stu, int exam_id)
+{
+    std::memset(&stu, 0, sizeof(stu));
+    stu.exam_id = exam_id;
+    std::strcpy(stu.name, "bench");
+    std::strcpy(stu.gender, exam_id % 2 == 0 ? "男" : "女");
+    stu.age = MIN_AGE + exam_id % (MAX_AGE - MIN_AGE + 1);
+    std::strcpy(stu.category, "软件设计师");
+}
+
+static void *RunConcurrentBenchTask(void *arg)
+{
+    ConcurrentBenchTask *task = (ConcurrentBenchTask *)arg;
+    unsigned int state = task->seed;
+    Student stu;
+    for (int i = 0; i < task->ops; ++i)
+    {
+        int exam_id = NextRandom(state) % task->key_range + 1;
+        int dice = NextRandom(state) % 100;
+        if (dice < task->read_percent)
+        {
+            task->hits += task->registry->Find(exam_id, &stu);
+        }
+        else if (dice % 2 == 0)
+        {
+            FillBenchStudent(stu, exam_id);
+            task->registry->Insert(stu);
+        }
+        else
+        {
+            task->registry->Erase(exam_id);
+        }
+    }
+    return nullptr;
+}
+
+static void RunConcurrentBenchmark(int max_threads, int ops_per_thread, int read_percent)
+{
+    const int KEY_RANGE = 999999;
+    const int THREAD_LIMIT = 64;
+    if (max_threads > THREAD_LIMIT)
+    {
+        max_threads = THREAD_LIMIT;
+    }
+
+    std::cout << "并发压测: 每线程 " << ops_per_thread << " 次操作, 读 " << read_percent
+              << "% / 写 " << (100 - read_percent) << "%, 预置 " << KEY_RANGE / 2 << " 名考生\n";
+    std::cout << "分片数\t线程数\t耗时(ms)\t吞吐(万次/秒)\t加速比\n";
+
+    const int shard_options[2] = {1, ConcurrentRegistry::DEFAULT_SHARDS};
+    for (int s = 0; s < 2; ++s)
+    {
+        double base_throughput = 0;
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            ConcurrentRegistry registry(shard_options[s]);
+            Student stu;
+            for (int id = 1; id <= KEY_RANGE; id += 2)
+            {
+                FillBenchStudent(stu, id);
+                registry.Insert(stu);
+            }
+
+            ConcurrentBenchTask tasks[THREAD_LIMIT];
+            pthread_t handles[THREAD_LIMIT];
+            long long start = NowMicros();
+            int started = 0;
+            for (; started < threads; ++started)
+            {
+                ConcurrentBenchTask &task = tasks[started];
+                task.registry = &registry;
+                task.ops = ops_per_thread;
+                task.read_percent = read_percent;
+                task.key_range = KEY_RANGE;
+                task.seed = 2463534242u + 7919u * started;
+                task.hits = 0;
+                if (pthread_create(&handles[started], nullptr, RunConcurrentBenchTask, &task) != 0)
+                {
+                    break;
+                }
+            }
+            for (int t = 0; t < started; ++t)
+            {
+                pthread_join(handles[t], nullptr);
+            }
+            long long elapsed = NowMicros() - start;
+            if (started < threads)
+            {
+                std::cout << "*** 错误: 只创建了 " << started << " 个线程(请求 " << threads
+                          << " 个), 压测中止 ***" << std::endl;
+                return;
+            }
+
+            double throughput = (double)ops_per_thread * threads / (elapsed > 0 ? elapsed : 1) * 1e6;
+            if (threads == 1)
+            {
+                base_throughput = throughput;
+            }
+            std::cout << shard_options[s] << "\t" << threads << "\t" << elapsed / 1000.0 << "\t\t"
+                      << throughput / 10000 << "\t\t" << throughput / base_throughput << "\n";
+
+            if (threads * 2 > max_threads && threads != max_threads)
+            {
+                threads = max_threads / 2; // 保证最后一轮恰好是 max_threads
+            }
+        }
+    }
+    std::cout << std::flush;
+}
+
+// ==================== 快照压测 ====================
+// 写线程持续增删改, 同时一个报表线程反复取快照做全表统计,
+// 对比有无报表线程时的写吞吐, 并核对每份快照: 考号不重复、记录不残缺。
+struct SnapshotBenchTask
+{
+    ConcurrentRegistry *registry;
+    int ops;
+    int key_range;
+    unsigned int seed;
+};
+
+// 报表线程的统计结果
+struct SnapshotReport
+{
+    ConcurrentRegistry *registry;
+    int key_range;
+    volatile int stop;  // 写线程全部结束后置 1
+    int snapshots;      // 完成的快照数
+    long long scan_us;  // 扫描总耗时
+    long long max_us;   // 最长一次扫描
+    int anomalies;      // 重复考号或残缺记录数
+    int last_count;     // 最后一份快照的考生数
+    int last_male;
+    double last_avg_age;
+};
+
+// 修改时年龄、性别、姓名一起改写, 姓名为年龄的十进制数, 用于检查记录是否残缺
+static void FillVersionedStudent(Student &stu, int exam_id, unsigned int version)
+{
+    FillBenchStudent(stu, exam_id);
+    stu.age = MIN_AGE + version % (MAX_AGE - MIN_AGE + 1);
+    std::strcpy(stu.gender, stu.age % 2 == 0 ? "男" : "女");
+    stu.name[0] = '0' + stu.age / 10;
+    stu.name[1] = '0' + stu.age % 10;
+    stu.name[2] = '\0';
+}
+
+static bool IsWholeRecord(const Student &stu)
+{
+    if (std::strcmp(stu.name, "bench") == 0)
+    {
+        return true; // 预置后未被修改过
+    }
+    bool male = std::strcmp(stu.gender, "男") == 0;
+    return stu.name[0] - '0' == stu.age / 10 && stu.name[1] - '0' == stu.age % 10 &&
+           male == (stu.age % 2 == 0);
+}
+
+static void *RunSnapshotWriterTask(void *arg)
+{
+    SnapshotBenchTask *task = (SnapshotBenchTask *)arg;
+    unsigned int state = task->seed;
+    Student stu;
+    for (int i = 0; i < task->ops; ++i)
+    {
+        int exam_id = NextRandom(state) % task->key_range + 1;
+        unsigned int dice = NextRandom(state);
+        if (dice % 3 == 0)
+        {
+            FillBenchStudent(stu, exam_id);
+            task->registry->Insert(stu);
+        }
+        else if (dice % 3 == 1)
+        {
+            task->registry->Erase(exam_id);
+        }
+        else
+        {
+            FillVersionedStudent(stu, exam_id, dice >> 8);
+            task->registry->Update(stu);
+        }
+    }
+    return nullptr;
+}
+
+static void *RunSnapshotReportTask(void *arg)
+{
+    SnapshotReport *report = (SnapshotReport *)arg;
+    // seen[id] 记录考号最近一次出现在第几份快照中, 免得每份快照都清零
+    int *seen = new int[report->key_range + 1]();
+    do
+    {
+        int snapshot = report->snapshots + 1;
+        int count = 0;
+        int male = 0;
+        long long age_sum = 0;
+        auto tally = [&](const Student &stu) {
+            if (seen[stu.exam_id] == snapshot || !IsWholeRecord(stu))
+            {
+                report->anomalies++;
+            }
+            seen[stu.exam_id] = snapshot;
+            count++;
+            male += std::strcmp(stu.gender, "男") == 0;
+            age_sum += stu.age;
+        };
+
+        long long start = NowMicros();
+        report->registry->ScanSnapshot(tally);
+        long long elapsed = NowMicros() - start;
+
+        report->snapshots = snapshot;
+        report->scan_us += elapsed;
+        if (elapsed > report->max_us)
+        {
+            report->max_us = elapsed;
+        }
+        report->last_count = count;
+        report->last_male = male;
+        report->last_avg_age = count > 0 ? (double)age_sum / count : 0;
+    } while (!__atomic_load_n(&report->stop, __ATOMIC_ACQUIRE));
+    delete[] seen;
+    return nullptr;
+}
+
+static void RunSnapshotBenchmark(int writer_threads, int ops_per_thread)
+{
+    const int KEY_RANGE = 999999;
+    const int THREAD_LIMIT = 64;
+    if (writer_threads > THREAD_LIMIT)
+    {
+        writer_threads = THREAD_LIMIT;
+    }
+
+    std::cout << "快照压测: " << writer_threads << " 个写线程, 每线程 " << ops_per_thread
+              << " 次增删改(各占三分之一), 预置 " << KEY_RANGE / 2 << " 名考生\n";
+    std::cout << "报表线程\t写耗时(ms)\t写吞吐(万次/秒)\t快照数\t平均扫描(ms)\t最长扫描(ms)\t异常\n";
+
+    for (int with_report = 0; with_report < 2; ++with_report)
+    {
+        ConcurrentRegistry registry;
+        Student stu;
+        for (int id = 1; id <= KEY_RANGE; id += 2)
+        {
+            FillBenchStudent(stu, id);
+            registry.Insert(stu);
+        }
+
+        SnapshotReport report;
+        std::memset(&report, 0, sizeof(report));
+        report.registry = &registry;
+        report.key_range = KEY_RANGE;
+        pthread_t report_handle;
+        if (with_report && pthread_create(&report_handle, nullptr, RunSnapshotReportTask, &report) != 0)
+        {
+            std::cout << "*** 错误: 无法创建报表线程, 压测中止 ***" << std::endl;
+            return;
+        }
+
+        SnapshotBenchTask tasks[THREAD_LIMIT];
+        pthread_t handles[THREAD_LIMIT];
+        long long start = NowMicros();
+        int started = 0;
+        for (; started < writer_threads; ++started)
+        {
+            SnapshotBenchTask &task = tasks[started];
+            task.registry = &registry;
+            task.ops = ops_per_thread;
+            task.key_range = KEY_RANGE;
+            task.seed = 88172645u + 7919u * started;
+            if (pthread_create(&handles[started], nullptr, RunSnapshotWriterTask, &task) != 0)
+            {
+                break;
+            }
+        }
+        for (int t = 0; t < started; ++t)
+        {
+            pthread_join(handles[t], nullptr);
+        }
+        long long elapsed = NowMicros() - start;
+        if (with_report)
+        {
+            __atomic_store_n(&report.stop, 1, __ATOMIC_RELEASE);
+            pthread_join(report_handle, nullptr);
+        }
+        if (started < writer_threads)
+        {
+            std::cout << "*** 错误: 只创建了 " << started << " 个写线程(请求 " << writer_threads
+                      << " 个), 压测中止 ***" << std::endl;
+            return;
+        }
+
+        double throughput = (double)ops_per_thread * writer_threads / (elapsed > 0 ? elapsed : 1) * 1e6;
+        std::cout << (with_report ? "有" : "无") << "\t\t" << elapsed / 1000.0 << "\t\t" << throughput / 10000
+                  << "\t\t" << report.snapshots << "\t"
+                  << (report.snapshots > 0 ? report.scan_us / 1000.0 / report.snapshots : 0) << "\t\t"
+                  << report.max_us / 1000.0 << "\t\t" << report.anomalies << "\n";
+        if (with_report && report.snapshots > 0)
+        {
+            std::cout << "  最后一份快照: " << report.last_count << " 名考生, 男 " << report.last_male
+                      << " / 女 " << report.last_count - report.last_male
+                      << ", 平均年龄 " << report.last_avg_age << "\n";
+        }
+    }
+    std::cout << std::flush;
+}
+
+// ==================== 批量查找压测 ====================
+// 在同一张表上分别用逐个 Find 与 FindBatch 查找同一份随机考号清单, 比较耗时。
+template <typename Table>
+static void RunBatchLookupBenchmark(const char *name, int records, int queries)
+{
+    Table table;
+    table.Reserve(records);
+    StudentRecord record;
+    std::memset(&record, 0, sizeof(record));
+    for (int id = 1; id <= records; ++id)
+    {
+        record.exam_id = id;
+        record.age = MIN_AGE + id % (MAX_AGE - MIN_AGE + 1);
+        table.Insert(record.exam_id, record);
+    }
+
+    // 约九成考号命中
+    int *exam_ids = new int[queries];
+    unsigned int state = 2463534242u;
+    for (int i = 0; i < queries; ++i)
+    {
+        exam_ids[i] = NextRandom(state) % (records + records / 9) + 1;
+    }
+    StudentRecord **results = new StudentRecord *[queries];
+
+    long long start = NowMicros();
+    for (int i = 0; i < queries; ++i)
+    {
+        results[i] = table.Find(exam_ids[i]);
+    }
+    long long loop_us = NowMicros() - start;
+    int loop_hits = 0;
+    for (int i = 0; i < queries; ++i)
+    {
+        loop_hits += results[i] != nullptr;
+    }
+
+    start = NowMicros();
+    table.FindBatch(exam_ids, queries, results);
+    long long batch_us = NowMicros() - start;
+    int batch_hits = 0;
+    for (int i = 0; i < queries; ++i)
+    {
+        batch_hits += results[i] != nullptr;
+    }
+
+    std::cout << name << "\t" << records << "\t" << loop_us / 1000.0 << "\t\t" << batch_us / 1000.0
+              << "\t\t" << (double)loop_us / (batch_us > 0 ? batch_us : 1)
+              << (loop_hits == batch_hits ? "" : "\t(结果不一致!)") << "\n";
+
+    delete[] results;
+    delete[] exam_ids;
+}
+
+static void RunBatchBenchmark(int queries)
+{
+    std::cout << "批量查找压测: 每轮 " << queries << " 个考号\n";
+    std::cout << "引擎\t考生数\t逐个查找(ms)\t批量查找(ms)\t加速比\n";
+    const int sizes[3] = {10000, 100000, 900000};
+    for (int i = 0; i < 3; ++i)
+    {
+        RunBatchLookupBenchmark<ChainedRecordTable>("拉链法", sizes[i], queries);
+        RunBatchLookupBenchmark<OpenRecordTable>("开放定址", sizes[i], queries);
+    }
+    std::cout << std::flush;
+}
+
+// ==================== 哈希表压测 ====================
+// 合成考号负载, 分别测两种存储引擎的插入/查找/删除与读写混合:
+//   均匀考号: 1..999999 中随机取互不相同的考号
+//   聚集考号: 随机挑若干考场, 每个考场 100 个连号座位(考号 = 考场号 * 100 + 座位号)
+// 每次操作用时间戳计数器计时(含约十余纳秒的计时开销), 报告吞吐与延迟分位数;
+// 拉链法另报告当前乘法散列 Hash() 下的链长分布, 与理想散列的泊松分布对照。
+
+// 读时间戳计数器; 非 x86 平台退化为微秒时钟
+static unsigned long long ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return NowMicros() * 1000;
+#endif
+}
+
+// 每纳秒的计数器周期数, 用 20 ms 墙上时间标定
+static double CyclesPerNano()
+{
+    long long start_us = NowMicros();
+    unsigned long long start_cycles = ReadCycles();
+    while (NowMicros() - start_us < 20000)
+    {
+    }
+    long long elapsed_us = NowMicros() - start_us;
+    return (double)(ReadCycles() - start_cycles) / (elapsed_us * 1000.0);
+}
+
+// 无符号整数基数排序(每轮 8 位, 共 4 轮)
+static void RadixSort(unsigned int *values, unsigned int *scratch, int n)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int count[257] = {0};
+        for (int i = 0; i < n; ++i)
+        {
+            count[((values[i] >> shift) & 0xFF) + 1]++;
+        }
+        for (int b = 0; b < 256; ++b)
+        {
+            count[b + 1] += count[b];
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            scratch[count[(values[i] >> shift) & 0xFF]++] = values[i];
+        }
+        unsigned int *swap = values;
+        values = scratch;
+        scratch = swap;
+    }
+}
+
+// 一个压测阶段的逐次延迟(周期数)
+struct LatencySamples
+{
+    unsigned int *cycles;
+    unsigned int *scratch;
+    int count;
+    long long elapsed_us;
+};
+
+static void PrintLatencyRow(const char *name, LatencySamples &samples, double cycles_per_ns)
+{
+    RadixSort(samples.cycles, samples.scratch, samples.count);
+    const double quantiles[4] = {0.5, 0.9, 0.99, 0.999};
+    std::cout << "  " << name << "\t" << (double)samples.count / (samples.elapsed_us > 0 ? samples.elapsed_us : 1)
+              << "\t";
+    for (int q = 0; q < 4; ++q)
+    {
+        int index = (int)(quantiles[q] * (samples.count - 1));
+        std::cout << "\t" << (int)(samples.cycles[index] / cycles_per_ns);
+    }
+    std::cout << "\n";
+}
+
+// 生成 count 个互不相同的考号: ids[0, count) 供插入, 其后 count 个保证不在表中
+static void GenerateExamIds(int *ids, int count, bool clustered, unsigned int &state)
+{
+    const int MAX_ID = 999999;
+    const int SEATS = 100;
+    if (!clustered)
+    {
+        // 部分 Fisher-Yates 洗牌取前 2 * count 个
+        int *pool = new int[MAX_ID];
+        for (int i = 0; i < MAX_ID; ++i)
+        {
+            pool[i] = i + 1;
+        }
+        for (int i = 0; i < 2 * count; ++i)
+        {
+            int j = i + NextRandom(state) % (MAX_ID - i);
+            int swap = pool[i];
+            pool[i] = pool[j];
+            pool[j] = swap;
+            ids[i] = pool[i];
+        }
+        delete[] pool;
+        return;
+    }
+
+    // 洗牌考场号, 前一半考场的座位依次入表, 后一半考场的座位作为缺失考号
+    int halls = MAX_ID / SEATS;
+    int *order = new int[halls];
+    for (int i = 0; i < halls; ++i)
+    {
+        order[i] = i + 1;
+    }
+    for (int i = halls - 1; i > 0; --i)
+    {
+        int j = NextRandom(state) % (i + 1);
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+    int used = (count + SEATS - 1) / SEATS;
+    for (int i = 0; i < 2 * count; ++i)
+    {
+        int k = i < count ? i : i - count;
+        int hall = order[(i < count ? 0 : used) + k / SEATS];
+        ids[i] = hall * SEATS + k % SEATS;
+    }
+    delete[] order;
+}
+
+template <typename Table>
+static void RunTableWorkload(Table &table, const int *source_ids, int count, double cycles_per_ns)
+{
+    const int READ_MIXES[3] = {50, 90, 99};
+    int mixed_ops = count > 200000 ? count : 200000;
+    int capacity = mixed_ops > 2 * count ? mixed_ops : 2 * count;
+    LatencySamples samples;
+    samples.cycles = new unsigned int[capacity];
+    samples.scratch = new unsigned int[capacity];
+
+    // ids[0, present) 在表中, ids[present, 2 * count) 不在表中
+    int *ids = new int[2 * count];
+    std::memcpy(ids, source_ids, sizeof(int) * 2 * count);
+    StudentRecord record;
+    std::memset(&record, 0, sizeof(record));
+    StudentRecord removed;
+    unsigned int state = 88172645u;
+    unsigned long long sink = 0;
+
+    long long start = NowMicros();
+    for (int i = 0; i < count; ++i)
+    {
+        record.exam_id = ids[i];
+        unsigned long long t0 = ReadCycles();
+        table.Insert(record.exam_id, record);
+        samples.cycles[i] = ReadCycles() - t0;
+    }
+    samples.elapsed_us = NowMicros() - start;
+    samples.count = count;
+    PrintLatencyRow("插入", samples, cycles_per_ns);
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int base = pass == 0 ? 0 : count;
+        start = NowMicros();
+        for (int i = 0; i < count; ++i)
+        {
+            int id = ids[base + NextRandom(state) % count];
+            unsigned long long t0 = ReadCycles();
+            sink += table.Find(id) != nullptr;
+            samples.cycles[i] = ReadCycles() - t0;
+        }
+        samples.elapsed_us = NowMicros() - start;
+        PrintLatencyRow(pass == 0 ? "查找命中" : "查找未中", samples, cycles_per_ns);
+    }
+
+    // 写操作交替删除一个在表考号、插入一个不在表考号, 表的规模保持不变
+    int present = count;
+    for (int m = 0; m < 3; ++m)
+    {
+        bool insert_next = false;
+        start = NowMicros();
+        for (int i = 0; i < mixed_ops; ++i)
+        {
+            unsigned int r = NextRandom(state);
+            unsigned long long t0;
+            if ((int)(r % 100) < READ_MIXES[m])
+            {
+                int id = ids[(r >> 8) % (2 * count)];
+                t0 = ReadCycles();
+                sink += table.Find(id) != nullptr;
+            }
+            else if (insert_next)
+            {
+                int j = present + (r >> 8) % (2 * count - present);
+                int swap = ids[j];
+                ids[j] = ids[present];
+                ids[present++] = swap;
+                record.exam_id = swap;
+                t0 = ReadCycles();
+                table.Insert(record.exam_id, record);
+            }
+            else
+            {
+                int j = (r >> 8) % present;
+                int swap = ids[j];
+                ids[j] = ids[--present];
+                ids[present] = swap;
+                t0 = ReadCycles();
+                table.Erase(swap, &removed);
+            }
+            if ((int)(r % 100) >= READ_MIXES[m])
+            {
+                insert_next = !insert_next;
+            }
+            samples.cycles[i] = ReadCycles() - t0;
+        }
+        samples.elapsed_us = NowMicros() - start;
+        samples.count = mixed_ops;
+        char name[32];
+        std::strcpy(name, "混合读");
+        int length = std::strlen(name);
+        name[length++] = '0' + READ_MIXES[m] / 10;
+        name[length++] = '0' + READ_MIXES[m] % 10;
+        name[length++] = '%';
+        name[length] = '\0';
+        PrintLatencyRow(name, samples, cycles_per_ns);
+    }
+
+    start = NowMicros();
+    for (int i = 0; i < present; ++i)
+    {
+        unsigned long long t0 = ReadCycles();
+        table.Erase(ids[i], &removed);
+        samples.cycles[i] = ReadCycles() - t0;
+    }
+    samples.elapsed_us = NowMicros() - start;
+    samples.count = present;
+    PrintLatencyRow("删除", samples, cycles_per_ns);
+
+    if (sink == 0 || table.Size() != 0)
+    {
+        std::cout << "  *** 压测结果异常: 表中残留 " << table.Size() << " 条记录 ***\n";
+    }
+    delete[] ids;
+    delete[] samples.scratch;
+    delete[] samples.cycles;
+}
+
+// 插入后立即统计链长, 与同样装载因子下的泊松分布对照
+static void PrintChainHistogram(const int *ids, int count)
+{
+    const int MAX_LENGTH = 8;
+    ChainedRecordTable table;
+    StudentRecord record;
+    std::memset(&record, 0, sizeof(record));
+    for (int i = 0; i < count; ++i)
+    {
+        record.exam_id = ids[i];
+        table.Insert(record.exam_id, record);
+    }
+    int histogram[MAX_LENGTH + 1];
+    table.ChainLengthHistogram(histogram, MAX_LENGTH);
+    TableStats stats = table.Stats();
+    int buckets = 0;
+    for (int k = 0; k <= MAX_LENGTH; ++k)
+    {
+        buckets += histogram[k];
+    }
+
+    std::cout << "  链长分布(桶数 " << buckets << ", 装载因子 " << (double)count / buckets
+              << ", 最长链 " << stats.max_chain_length << "):\n  链长\t实际%\t泊松%\n";
+    double lambda = (double)count / buckets;
+    double poisson = std::exp(-lambda);
+    double tail = 1.0;
+    for (int k = 0; k <= MAX_LENGTH; ++k)
+    {
+        double expected = k < MAX_LENGTH ? poisson : tail;
+        std::cout << "  " << k << (k == MAX_LENGTH ? "+" : "") << "\t"
+                  << 100.0 * histogram[k] / buckets << "\t" << 100.0 * expected << "\n";
+        tail -= poisson;
+        poisson *= lambda / (k + 1);
+    }
+}
+
+static void RunTableBenchmark()
+{
+    const int SIZES[3] = {10000, 100000, 450000};
+    double cycles_per_ns = CyclesPerNano();
+    std::cout << "哈希表压测(吞吐单位 百万次/秒, 延迟单位 ns)\n";
+    for (int clustered = 0; clustered < 2; ++clustered)
+    {
+        for (int s = 0; s < 3; ++s)
+        {
+            int count = SIZES[s];
+            int *ids = new int[2 * count];
+            unsigned int state = 2463534242u + count;
+            GenerateExamIds(ids, count, clustered != 0, state);
+
+            const char *workload = clustered ? "聚集考号" : "均匀考号";
+            std::cout << "\n=== " << workload << ", " << count << " 名考生 ===\n";
+            std::cout << "  操作\t吞吐\t\tp50\tp90\tp99\tp99.9\n";
+            std::cout << "  [拉链法]\n";
+            {
+                ChainedRecordTable table;
+                RunTableWorkload(table, ids, count, cycles_per_ns);
+            }
+            std::cout << "  [开放定址]\n";
+            {
+                OpenRecordTable table;
+                RunTableWorkload(table, ids, count, cycles_per_ns);
+            }
+            PrintChainHistogram(ids, count);
+            delete[] ids;
+        }
+    }
+    std::cout << std::flush;
+}
+
+// ==================== 主函数 ====================
+int main(int argc, char *argv[])
+{
+    // 可选参数:
+    //   --open-addressing     使用开放定址存储引擎
+    //   --load <文件>         启动时从 CSV/TSV 文件批量导入考生
+    //   --snapshot <文件>     启动时从二进制快照恢复, 退出时写回
+    //   --wal <文件>          开启预写日志, 启动时先重放
+    //   --wal-batch <条数>    组提交的批大小(默认 64)
+    //   --wal-interval <毫秒> 组提交的最长等待(默认 100)
+    //   --wal-compact <MB>    日志超过该大小时压缩进快照(默认 64)
+    //   --verify <文件>       核对考号清单(每行一个考号)后退出
+    //   --batch <文件>        执行命令文件("-" 为标准输入)代替交互菜单
+    //   --bench               运行哈希表压测(两种引擎, 均匀/聚集考号)后退出
+    //   --bench-batch         运行批量查找压测后退出(--ops 为考号数, 默认 50000)
+    //   --bench-concurrent    运行并发压测后退出, 可配合:
+    //     --threads <线程数>  最大线程数(默认为 CPU 核数)
+    //     --ops <次数>        每线程操作数(默认 1000000)
+    //     --read-percent <N>  读操作占比(默认 90)
+    //   --bench-snapshot      运行快照压测后退出(--threads 为写线程数, --ops 为每线程操作数)
+    StorageEngine engine = CHAINING_ENGINE;
+    const char *load_path = nullptr;
+    const char *snapshot_path = nullptr;
+    const char *wal_path = nullptr;
+    int wal_batch = 64;
+    int wal_interval_ms = 100;
+    int wal_compact_mb = 64;
+    const char *verify_path = nullptr;
+    const char *batch_path = nullptr;
+    bool bench_table = false;
+    bool bench_batch = false;
+    bool bench_concurrent = false;
+    bool bench_snapshot = false;
+    int bench_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int bench_ops = 0;
+    int bench_read_percent = 90;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : "";
+        const char *value_end = value + std::strlen(value);
+        if (std::strcmp(argv[i], "--open-addressing") == 0)
+        {
+            engine = OPEN_ADDRESSING_ENGINE;
+        }
+        else if (std::strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            load_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+        {
+            snapshot_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--wal") == 0 && i + 1 < argc)
+        {
+            wal_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--wal-batch") == 0 && ParseIntField(value, value_end, wal_batch))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--wal-interval") == 0 && ParseIntField(value, value_end, wal_interval_ms))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--wal-compact") == 0 && ParseIntField(value, value_end, wal_compact_mb))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--verify") == 0 && i + 1 < argc)
+        {
+            verify_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+        {
+            batch_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--bench") == 0)
+        {
+            bench_table = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-batch") == 0)
+        {
+            bench_batch = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-concurrent") == 0)
+        {
+            bench_concurrent = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-snapshot") == 0)
+        {
+            bench_snapshot = true;
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && ParseIntField(value, value_end, bench_threads))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--ops") == 0 && ParseIntField(value, value_end, bench_ops))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--read-percent") == 0 && ParseIntField(value, value_end, bench_read_percent))
+        {
+            ++i;
+        }
+    }
+
+    if (bench_table)
+    {
+        RunTableBenchmark();
+        return 0;
+    }
+    if (bench_batch)
+    {
+        RunBatchBenchmark(bench_ops > 0 ? bench_ops : 50000);
+        return 0;
+    }
+    if (bench_concurrent)
+    {
+        RunConcurrentBenchmark(bench_threads > 0 ? bench_threads : 1,
+                               bench_ops > 0 ? bench_ops : 1000000, bench_read_percent);
+        return 0;
+    }
+    if (bench_snapshot)
+    {
+        RunSnapshotBenchmark(bench_threads > 0 ? bench_threads : 1, bench_ops > 0 ? bench_ops : 1000000);
+        return 0;
+    }
+
+    ExamRegistrationSystem system(engine);
+    if (snapshot_path != nullptr)
+    {
+        int restored = system.LoadSnapshot(snapshot_path);
+        if (restored < 0)
+        {
+            // 不继续运行, 免得退出时用空表覆盖损坏的快照
+            return 1;
+        }
+        if (restored > 0)
+        {
+            std::cout << "*** 从快照 " << snapshot_path << " 恢复 " << restored << " 名考生 ***" << std::endl;
+        }
+    }
+    if (wal_path != nullptr)
+    {
+        int replayed = system.ReplayLog(wal_path);
+        if (replayed > 0)
+        {
+            std::cout << "*** 从日志 " << wal_path << " 重放 " << replayed << " 条修改 ***" << std::endl;
+        }
+        if (!system.OpenLog(wal_path, snapshot_path, wal_batch, wal_interval_ms,
+                            (long)wal_compact_mb * 1024 * 1024))
+        {
+            return 1;
+        }
+    }
+    if (load_path != nullptr && system.LoadFromFile(load_path) < 0)
+    {
+        return 1;
+    }
+    if (verify_path != nullptr)
+    {
+        return system.VerifyExamIds(verify_path) == 0 ? 0 : 2;
+    }
+
+    int status = 0;
+    if (batch_path != nullptr)
+    {
+        int failed = system.RunBatch(batch_path);
+        status = failed < 0 ? 1 : (failed > 0 ? 2 : 0);
+    }
+    else
+    {
+        system.Run();
+    }
+
+    if (wal_path != nullptr)
+    {
+        // 有快照时退出前把日志压缩进快照
+        if (!system.CloseLog())
+        {
+            std::cout << "*** 错误: 部分修改未能写入日志或快照 ***" << std::endl;
+            status = 1;
+        }
+    }
+    else if (snapshot_path != nullptr && system.SaveSnapshot(snapshot_path) >= 0)
+    {
+        std::cout << "*** 已保存快照 " << snapshot_path << " ***" << std::endl;
+    }
+    return status;
 }
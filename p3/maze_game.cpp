@@ -1,18 +1,450 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <fcntl.h>     // 地图与查询文件的映射读取
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <pthread.h>   // 仅并行 BFS 使用
+
+/**
+ * 当前墙上时间（微秒）
+ */
+static long long NowMicros() {
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/**
+ * 读时间戳计数器；非 x86 平台退化为微秒时钟
+ */
+static unsigned long long ReadCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return NowMicros() * 1000;
+#endif
+}
+
+/**
+ * 每纳秒的计数器周期数，用 20 ms 墙上时间标定
+ */
+static double CyclesPerNano() {
+  long long start_us = NowMicros();
+  unsigned long long start_cycles = ReadCycles();
+  while (NowMicros() - start_us < 20000) {
+  }
+  long long elapsed_us = NowMicros() - start_us;
+  return (double)(ReadCycles() - start_cycles) / (elapsed_us * 1000.0);
+}
+
+/**
+ * 从 [*p, end) 读一个非负整数，跳过同一行内的前导空白
+ */
+static bool ReadInt(const char **p, const char *end, int *value) {
+  while (*p < end && (**p == ' ' || **p == '\t' || **p == '\r')) {
+    ++*p;
+  }
+  if (*p == end || **p < '0' || **p > '9') {
+    return false;
+  }
+  long long v = 0;
+  while (*p < end && **p >= '0' && **p <= '9') {
+    v = v * 10 + (**p - '0');
+    if (v > 2147483647LL) {
+      return false;
+    }
+    ++*p;
+  }
+  *value = (int)v;
+  return true;
+}
+
+/**
+ * 解析整个命令行参数为非负整数
+ */
+static bool ParseArgInt(const char *text, int *value) {
+  const char *end = text + std::strlen(text);
+  return ReadInt(&text, end, value) && text == end;
+}
+
+/**
+ * 只读内存映射文件
+ * 普通文件整体映射；管道等无法映射的输入（含路径 "-" 表示的标准输入）整体读入内存。
+ */
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0), buffered_(false) {}
+  ~MappedFile() { Close(); }
+  
+  bool Open(const char *path);
+  void Close();
+  
+  const char *data() const { return data_; }
+  long size() const { return size_; }
+  
+ private:
+  const char *data_;
+  long size_;
+  bool buffered_;  // data_ 为 new[] 分配的读入缓冲而非映射
+  
+  bool ReadStream(int fd);
+  
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+};
+
+/**
+ * 打开并映射整个文件
+ * @param path 文件路径，"-" 表示标准输入
+ * @return 成功返回true（空文件成功但 data() 为 nullptr）
+ */
+bool MappedFile::Open(const char *path) {
+  Close();
+  if (std::strcmp(path, "-") == 0) {
+    return ReadStream(STDIN_FILENO);
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  
+  long size = lseek(fd, 0, SEEK_END);
+  if (size < 0) {
+    bool ok = ReadStream(fd);
+    close(fd);
+    return ok;
+  }
+  if (size > 0) {
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    data_ = (const char *)addr;
+  }
+  size_ = size;
+  close(fd);  // 映射建立后即可关闭描述符
+  return true;
+}
+
+/**
+ * 把无法映射的输入整体读入内存，缓冲按两倍增长
+ */
+bool MappedFile::ReadStream(int fd) {
+  long capacity = 1 << 16;
+  char *data = new char[capacity];
+  long size = 0;
+  while (true) {
+    if (size == capacity) {
+      char *grown = new char[capacity * 2];
+      std::memcpy(grown, data, size);
+      delete[] data;
+      data = grown;
+      capacity *= 2;
+    }
+    long got = read(fd, data + size, capacity - size);
+    if (got < 0) {
+      delete[] data;
+      return false;
+    }
+    if (got == 0) {
+      break;
+    }
+    size += got;
+  }
+  data_ = data;
+  size_ = size;
+  buffered_ = true;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (buffered_) {
+    delete[] data_;
+  } else if (data_ != nullptr) {
+    munmap((void *)data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  buffered_ = false;
+}
 
 // 常量定义
-const int kMaxSize = 100;
 const int kDirections = 4;
+const int kMaxPrintSize = 100;  // 超过该行/列数的地图不打印网格
+const long long kMaxCells = 4294967295LL;  // 格子下标用 32 位无符号数保存
+const char kBinaryMapMagic[] = "MAZEBITS";  // 二进制地图文件开头的魔数
+const int kBinaryMapMagicSize = 8;
+const int kMaxThreads = 64;                // 并行 BFS 的线程数上限
 
 // 方向数组：下、右、上、左
 const int kDx[kDirections] = {1, 0, -1, 0};
 const int kDy[kDirections] = {0, 1, 0, -1};
 
+// 求解策略
+enum SolverType {
+  kDfsSolver,    // 深度优先（回溯法），找到第一条路径即停止
+  kBfsSolver,    // 广度优先，单位步长下给出最短路径
+  kAStarSolver,  // A*，曼哈顿距离为启发函数，给出最短路径
+  kBidirectionalSolver,  // 双向广度优先，从起点和终点同时扩展，给出最短路径
+  kParallelBfsSolver,    // 按层同步的多线程广度优先，给出最短路径
+  kJumpPointSolver,      // 跳点搜索，跳过开放区域中的直线段，给出最短路径
+  kSolverCount
+};
+
+const char *const kSolverNames[kSolverCount] = {"dfs", "bfs", "astar", "bidir", "pbfs", "jps"};
+
+/**
+ * 按名称查找求解策略
+ * @param name 策略名（dfs/bfs/astar/bidir/pbfs/jps）
+ * @param solver 输出找到的策略
+ * @return 名称有效返回true
+ */
+static bool ParseSolver(const char *name, SolverType *solver) {
+  for (int i = 0; i < kSolverCount; ++i) {
+    if (std::strcmp(name, kSolverNames[i]) == 0) {
+      *solver = (SolverType)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * A* 的开放表：按 (f, h) 排序的二叉小根堆
+ * f 相同时优先取 h 小（即离起点远）的格子，让搜索沿当前方向推进而不是在同 f 的层里铺开。
+ */
+class OpenList {
+ public:
+  struct Entry {
+    int f;              // 起点到此的步数 + 到终点的估计
+    int h;              // 到终点的估计
+    unsigned int cell;  // 格子下标
+  };
+  
+  OpenList() : entries_(nullptr), size_(0), capacity_(0) {}
+  ~OpenList() { delete[] entries_; }
+  
+  bool Empty() const { return size_ == 0; }
+  void Push(const Entry &entry);
+  Entry Pop();
+  
+ private:
+  Entry *entries_;
+  long long size_;
+  long long capacity_;
+  
+  static bool Less(const Entry &a, const Entry &b) {
+    return a.f < b.f || (a.f == b.f && a.h < b.h);
+  }
+};
+
+/**
+ * 入堆，空间不足时容量翻倍
+ */
+void OpenList::Push(const Entry &entry) {
+  if (size_ == capacity_) {
+    capacity_ = capacity_ == 0 ? 1024 : capacity_ * 2;
+    Entry *entries = new Entry[capacity_];
+    if (size_ > 0) {
+      std::memcpy(entries, entries_, sizeof(Entry) * size_);
+    }
+    delete[] entries_;
+    entries_ = entries;
+  }
+  // 上滤
+  long long i = size_++;
+  while (i > 0 && Less(entry, entries_[(i - 1) / 2])) {
+    entries_[i] = entries_[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  entries_[i] = entry;
+}
+
+/**
+ * 弹出堆顶（调用方保证堆非空）
+ */
+OpenList::Entry OpenList::Pop() {
+  Entry top = entries_[0];
+  Entry last = entries_[--size_];
+  // 下滤
+  long long i = 0;
+  while (2 * i + 1 < size_) {
+    long long child = 2 * i + 1;
+    if (child + 1 < size_ && Less(entries_[child + 1], entries_[child])) {
+      ++child;
+    }
+    if (!Less(entries_[child], last)) {
+      break;
+    }
+    entries_[i] = entries_[child];
+    i = child;
+  }
+  entries_[i] = last;
+  return top;
+}
+
+/**
+ * 位压缩网格：墙与访问标记各占一个位集，每格共 2 位
+ * 每行按 64 位字对齐，并在行尾至少留一位填充；上下各多留一整行。
+ * 填充位与上下两行全部标记为墙，因此坐标取 -1..rows、-1..cols 时也能直接测试，
+ * 邻居扩展无需做越界检查（列 -1 落在上一行行尾的填充位上）。
+ * 墙与访问标记按同一布局存放，一个字同时给出 64 个格子是否可走。
+ */
+class BitGrid {
+ public:
+  BitGrid()
+      : walls_(nullptr), visited_(nullptr), back_visited_(nullptr),
+        rows_(0), cols_(0), words_per_row_(0) {}
+  ~BitGrid() { Release(); }
+  
+  // 按行列数重新分配，所有格子为通路且未访问
+  void Resize(int rows, int cols);
+  void Release();
+  
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  int words_per_row() const { return words_per_row_; }
+  
+  bool IsWall(int x, int y) const { return TestBit(walls_, x, y); }
+  void SetWall(int x, int y) { SetBit(walls_, x, y); }
+  void ClearWall(int x, int y) {
+    long long bit = BitIndex(x, y);
+    walls_[bit >> 6] &= ~(1ULL << (bit & 63));
+  }
+  // 所有格子设为墙（生成迷宫时再逐格打通）
+  void FillWalls() { std::memset(walls_, 0xFF, sizeof(unsigned long long) * WordCount()); }
+  bool IsVisited(int x, int y) const { return TestBit(visited_, x, y); }
+  void MarkVisited(int x, int y) { SetBit(visited_, x, y); }
+  void ClearVisited();
+  
+  // 多线程搜索用：格子非墙且未被任何线程标记时原子地标记它并返回true，
+  // 多个线程同时标记同一格子时只有一个返回true
+  bool ClaimVisited(int x, int y) {
+    long long bit = BitIndex(x, y);
+    unsigned long long mask = 1ULL << (bit & 63);
+    unsigned long long *word = &visited_[bit >> 6];
+    if ((walls_[bit >> 6] & mask) != 0 || (__atomic_load_n(word, __ATOMIC_RELAXED) & mask) != 0) {
+      return false;
+    }
+    return (__atomic_fetch_or(word, mask, __ATOMIC_RELAXED) & mask) == 0;
+  }
+  
+  // 双向搜索中从终点一侧出发的访问标记，首次使用前由 AllocateBackMarks 分配
+  void AllocateBackMarks();
+  bool IsBackVisited(int x, int y) const { return TestBit(back_visited_, x, y); }
+  void MarkBackVisited(int x, int y) { SetBit(back_visited_, x, y); }
+  
+  // 非墙且未访问
+  bool IsOpen(int x, int y) const {
+    long long bit = BitIndex(x, y);
+    return (((walls_[bit >> 6] | visited_[bit >> 6]) >> (bit & 63)) & 1) == 0;
+  }
+  
+  // 第 x 行第 word 个字中可走（非墙且未访问）的格子，第 k 位对应列 word * 64 + k
+  unsigned long long OpenWord(int x, int word) const {
+    long long index = RowWord(x) + word;
+    return ~(walls_[index] | visited_[index]);
+  }
+  
+  // (x, y) 四个相邻格子中可走的，第 dir 位对应方向 dir（kDx/kDy 的顺序）。
+  // 左右两格与 (x, y) 通常在同一个字里，一次读出；只有 y 在字的边界上时才多读相邻的字
+  unsigned int OpenNeighbors(int x, int y) const {
+    int word = y >> 6;
+    int shift = y & 63;
+    unsigned long long row = OpenWord(x, word);
+    unsigned long long right = shift < 63 ? row >> (shift + 1) : OpenWord(x, word + 1);
+    unsigned long long left = shift > 0 ? row >> (shift - 1) : (word > 0 ? OpenWord(x, word - 1) >> 63 : 0);
+    return (unsigned int)((OpenWord(x + 1, word) >> shift) & 1) |
+           (unsigned int)(right & 1) << 1 |
+           (unsigned int)((OpenWord(x - 1, word) >> shift) & 1) << 2 |
+           (unsigned int)(left & 1) << 3;
+  }
+  
+  // 第 x 行第 word 个字中的墙
+  unsigned long long WallWord(int x, int word) const { return walls_[RowWord(x) + word]; }
+  
+  // 整字设墙：bits 的第 k 位对应列 word * 64 + k，超出列数的位落在本就是墙的填充位上
+  void AddWallWord(int x, int word, unsigned long long bits) { walls_[RowWord(x) + word] |= bits; }
+  
+  // 各位集共占用的字节数
+  long long MemoryBytes() const {
+    return (back_visited_ != nullptr ? 3 : 2) * WordCount() * (long long)sizeof(unsigned long long);
+  }
+  
+ private:
+  unsigned long long *walls_;
+  unsigned long long *visited_;
+  unsigned long long *back_visited_;
+  int rows_;
+  int cols_;
+  int words_per_row_;
+  
+  long long WordCount() const { return (long long)(rows_ + 2) * words_per_row_; }
+  long long RowWord(int x) const { return (long long)(x + 1) * words_per_row_; }
+  long long BitIndex(int x, int y) const { return RowWord(x) * 64 + y; }
+  bool TestBit(const unsigned long long *bits, int x, int y) const {
+    long long bit = BitIndex(x, y);
+    return ((bits[bit >> 6] >> (bit & 63)) & 1) != 0;
+  }
+  void SetBit(unsigned long long *bits, int x, int y) {
+    long long bit = BitIndex(x, y);
+    bits[bit >> 6] |= 1ULL << (bit & 63);
+  }
+};
+
+void BitGrid::Resize(int rows, int cols) {
+  Release();
+  rows_ = rows;
+  cols_ = cols;
+  words_per_row_ = cols / 64 + 1;  // 行尾至少一位填充
+  walls_ = new unsigned long long[WordCount()];
+  visited_ = new unsigned long long[WordCount()];
+  std::memset(visited_, 0, sizeof(unsigned long long) * WordCount());
+  
+  // 上下两行全为墙，其余各行只有行尾填充位为墙
+  std::memset(walls_, 0xFF, sizeof(unsigned long long) * WordCount());
+  for (int x = 0; x < rows; ++x) {
+    unsigned long long *row = walls_ + RowWord(x);
+    std::memset(row, 0, sizeof(unsigned long long) * (cols / 64));
+    row[cols / 64] = ~0ULL << (cols % 64);
+  }
+}
+
+void BitGrid::Release() {
+  delete[] walls_;
+  delete[] visited_;
+  delete[] back_visited_;
+  walls_ = nullptr;
+  visited_ = nullptr;
+  back_visited_ = nullptr;
+  rows_ = 0;
+  cols_ = 0;
+  words_per_row_ = 0;
+}
+
+void BitGrid::ClearVisited() {
+  std::memset(visited_, 0, sizeof(unsigned long long) * WordCount());
+  if (back_visited_ != nullptr) {
+    std::memset(back_visited_, 0, sizeof(unsigned long long) * WordCount());
+  }
+}
+
+void BitGrid::AllocateBackMarks() {
+  if (back_visited_ == nullptr) {
+    back_visited_ = new unsigned long long[WordCount()];
+    std::memset(back_visited_, 0, sizeof(unsigned long long) * WordCount());
+  }
+}
+
 /**
  * 迷宫类
- * 使用回溯法求解迷宫路径问题
+ * 支持回溯法（DFS）、广度优先（BFS）、A* 与双向广度优先四种求解策略，运行时选择
+ * 地图与访问标记存放在位压缩网格 BitGrid 中（每格 2 位），搜索栈按实际行列数在堆上分配，不限制迷宫大小；
+ * 深度优先搜索用显式栈代替递归，栈中每层只记一个字节的前进方向。
+ * BFS 与 A* 复用同一个字节数组记录每个格子的来向，找到终点后倒推出路径。
  */
 class Maze {
  public:
@@ -22,10 +454,41 @@ class Maze {
   
   // 公共接口
   void InputMaze();
-  bool SolveMaze();
+  bool LoadMap(const char *path);
+  bool SolveMaze(SolverType solver = kDfsSolver);
+  
   void PrintPath();
   void PrintMaze();
   
+  // 程序化构造迷宫（压测与生成用）：Resize 后全为通路，再逐格设墙；或 FillWalls 后逐格打通
+  bool Resize(int rows, int cols);
+  void SetWall(int x, int y) { grid_.SetWall(x, y); }
+  void ClearWall(int x, int y) { grid_.ClearWall(x, y); }
+  void FillWalls() { grid_.FillWalls(); }
+  void SetStart(int x, int y) { start_x_ = x; start_y_ = y; }
+  void SetEnd(int x, int y) { end_x_ = x; end_y_ = y; }
+  int start_x() const { return start_x_; }
+  int start_y() const { return start_y_; }
+  int end_x() const { return end_x_; }
+  int end_y() const { return end_y_; }
+  
+  // 只读地图，供多次查询的预处理使用
+  const BitGrid &grid() const { return grid_; }
+  
+  // 并行 BFS 的线程数，限制在 [1, kMaxThreads]
+  int threads() const { return threads_; }
+  void set_threads(int threads) {
+    threads_ = threads < 1 ? 1 : (threads > kMaxThreads ? kMaxThreads : threads);
+  }
+  
+  // 最近一次求解的统计
+  long long path_length() const { return path_length_; }
+  long long nodes_expanded() const { return nodes_expanded_; }
+  long long solve_micros() const { return solve_micros_; }
+  // 最近一次并行 BFS 的总层数与其中多线程扩展的层数
+  long long levels() const { return levels_; }
+  long long parallel_levels() const { return parallel_levels_; }
+  
  private:
   // 位置结构体，保存坐标和前进方向
   struct Position {
@@ -35,28 +498,52 @@ class Maze {
   };
   
   // 成员变量
-  int maze_[kMaxSize][kMaxSize];           // 迷宫地图
-  bool visited_[kMaxSize][kMaxSize];       // 访问标记数组
-  Position path_[kMaxSize * kMaxSize];     // 路径栈
+  BitGrid grid_;                            // 迷宫地图与访问标记
+  unsigned char *steps_;                    // DFS 搜索栈：第 i 层记录从第 i 个格子前进的方向；
+                                            // BFS/A*：steps_[格子] 记录到达该格子的方向
+  Position *path_;                          // 路径
   int rows_;                                // 行数
   int cols_;                                // 列数
   int start_x_;                             // 起点x坐标
   int start_y_;                             // 起点y坐标
   int end_x_;                               // 终点x坐标
   int end_y_;                               // 终点y坐标
-  int path_length_;                         // 路径长度
+  long long path_length_;                   // 路径长度
+  long long nodes_expanded_;                // 扩展（出栈/出队）的格子数
+  long long solve_micros_;                  // 求解用时（微秒）
+  long long levels_;                        // 并行 BFS 扩展的层数
+  long long parallel_levels_;               // 其中由多个线程一起扩展的层数
+  int threads_;                             // 并行 BFS 的线程数
   
   // 私有方法
-  bool IsValid(int x, int y);
+  long long Index(int x, int y) const { return (long long)x * cols_ + y; }
+  long long CellCount() const { return (long long)rows_ * cols_; }
+  void Allocate(int rows, int cols);
+  void Release();
+  bool LoadTextMap(const char *data, const char *end);
+  bool LoadBinaryMap(const char *data, const char *end);
+  bool InBounds(int x, int y) const { return x >= 0 && x < rows_ && y >= 0 && y < cols_; }
   bool DFS(int x, int y);
+  bool BFS();
+  bool AStar();
+  bool BidirectionalBFS();
+  bool ParallelBFS();
+  bool JumpPointSearch();
+  int JumpHorizontal(int x, int y, int dy) const;
+  int JumpVertical(int x, int y, int dx) const;
+  int Heuristic(int x, int y) const;
+  void BuildPath(int x, int y, long long depth);
+  void BuildPathFromParents();
+  void BuildMeetingPath(int x, int y, int dir);
+  long long CountSteps(int x, int y, int to_x, int to_y, bool toward_end) const;
 };
 
 /**
  * 构造函数：初始化迷宫对象
  */
 Maze::Maze() {
-  std::memset(maze_, 0, sizeof(maze_));
-  std::memset(visited_, false, sizeof(visited_));
+  steps_ = nullptr;
+  path_ = nullptr;
   rows_ = 0;
   cols_ = 0;
   start_x_ = 0;
@@ -64,25 +551,83 @@ Maze::Maze() {
   end_x_ = 0;
   end_y_ = 0;
   path_length_ = 0;
+  nodes_expanded_ = 0;
+  levels_ = 0;
+  parallel_levels_ = 0;
+  solve_micros_ = 0;
+  set_threads((int)sysconf(_SC_NPROCESSORS_ONLN));
 }
 
 /**
  * 析构函数
  */
 Maze::~Maze() {
+  Release();
+}
+
+/**
+ * 按行列数分配地图、访问标记和搜索栈，地图初始为全通路
+ * @param rows 行数
+ * @param cols 列数
+ */
+void Maze::Allocate(int rows, int cols) {
+  Release();
+  rows_ = rows;
+  cols_ = cols;
+  grid_.Resize(rows, cols);
+  // 每个格子至多入栈一次，栈深不超过格子数
+  steps_ = new unsigned char[CellCount()];
+}
+
+/**
+ * 释放所有堆上的数组
+ */
+void Maze::Release() {
+  grid_.Release();
+  delete[] steps_;
+  delete[] path_;
+  steps_ = nullptr;
+  path_ = nullptr;
+  rows_ = 0;
+  cols_ = 0;
+  path_length_ = 0;
+}
+
+/**
+ * 重新设置迷宫大小，所有格子为通路
+ * @param rows 行数
+ * @param cols 列数
+ * @return 行列数有效返回true，否则清空迷宫并返回false
+ */
+bool Maze::Resize(int rows, int cols) {
+  if (rows <= 0 || cols <= 0 || (long long)rows * cols > kMaxCells) {
+    Allocate(0, 0);
+    return false;
+  }
+  Allocate(rows, cols);
+  return true;
 }
 
 /**
  * 输入迷宫数据
  */
 void Maze::InputMaze() {
+  int rows = 0;
+  int cols = 0;
   std::cout << "请输入迷宫的行数和列数：";
-  std::cin >> rows_ >> cols_;
+  std::cin >> rows >> cols;
+  if (!Resize(rows, cols)) {
+    std::cout << "迷宫行列数无效！" << std::endl;
+  }
   
   std::cout << "请输入迷宫地图 (0表示通路，1表示墙壁)：" << std::endl;
   for (int i = 0; i < rows_; ++i) {
     for (int j = 0; j < cols_; ++j) {
-      std::cin >> maze_[i][j];
+      int cell = 0;
+      std::cin >> cell;
+      if (cell == 1) {
+        grid_.SetWall(i, j);
+      }
     }
   }
   
@@ -94,151 +639,1904 @@ void Maze::InputMaze() {
 }
 
 /**
- * 检查位置是否有效
- * @param x 行坐标
- * @param y 列坐标
- * @return 如果位置有效返回true，否则返回false
+ * 从文件载入迷宫：整个文件映射进内存后直接写入位图，不经过逐格的流提取
+ * 以魔数 kBinaryMapMagic 开头的按二进制位图解析，否则按文本解析，两种格式见
+ * LoadTextMap / LoadBinaryMap。
+ * @param path 地图文件路径，"-" 表示标准输入
+ * @return 载入成功返回true，失败时输出原因并返回false
  */
-bool Maze::IsValid(int x, int y) {
-  return x >= 0 && x < rows_ && y >= 0 && y < cols_ && 
-         maze_[x][y] == 0 && !visited_[x][y];
+bool Maze::LoadMap(const char *path) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    std::cout << "无法打开地图文件：" << path << std::endl;
+    return false;
+  }
+  const char *data = file.data();
+  const char *end = data + file.size();
+  if (file.size() >= kBinaryMapMagicSize && std::memcmp(data, kBinaryMapMagic, kBinaryMapMagicSize) == 0) {
+    return LoadBinaryMap(data + kBinaryMapMagicSize, end);
+  }
+  return LoadTextMap(data, end);
 }
 
 /**
- * 深度优先搜索（回溯法）
- * @param x 当前行坐标
- * @param y 当前列坐标
- * @return 如果找到路径返回true，否则返回false
+ * 文本地图：首行 "行数 列数"，随后每行一个地图行，每格一个字符
+ * （1 或 # 为墙，0 或 . 为通路；行内空格、制表符忽略，因此原来空格分隔的输入也能直接载入）。
+ * 没有格子的空行跳过。地图后可选两行起点、终点坐标（从0开始），缺省为左上角与右下角。
+ * 每行的格子先拼成 64 位的字，再整字写入位图。
  */
-bool Maze::DFS(int x, int y) {
-  // 到达终点
-  if (x == end_x_ && y == end_y_) {
-    path_[path_length_].x = x;
-    path_[path_length_].y = y;
-    path_[path_length_].direction = -1;
-    path_length_++;
-    return true;
+bool Maze::LoadTextMap(const char *data, const char *end) {
+  const char *p = data;
+  int rows = 0;
+  int cols = 0;
+  if (!ReadInt(&p, end, &rows) || !ReadInt(&p, end, &cols) || rows <= 0 || cols <= 0) {
+    Allocate(0, 0);
+    std::cout << "地图文件首行应为有效的行数和列数！" << std::endl;
+    return false;
   }
+  // 每格至少一个字符：剩余字节放不下这么多格时不必分配就能判定文件不完整
+  if ((long long)rows * cols > end - p) {
+    Allocate(0, 0);
+    std::cout << "地图文件只有 " << (end - p) << " 字节，装不下 " << rows << " x " << cols << " 的地图！" << std::endl;
+    return false;
+  }
+  if (!Resize(rows, cols)) {
+    Allocate(0, 0);
+    std::cout << "地图文件首行应为有效的行数和列数！" << std::endl;
+    return false;
+  }
+  p = (const char *)std::memchr(p, '\n', end - p);
+  p = p != nullptr ? p + 1 : end;
   
-  // 标记当前位置已访问
-  visited_[x][y] = true;
-  path_[path_length_].x = x;
-  path_[path_length_].y = y;
-  
-  // 尝试四个方向（右、下、左、上）
-  for (int dir = 0; dir < kDirections; ++dir) {
-    int next_x = x + kDx[dir];
-    int next_y = y + kDy[dir];
-    
-    if (IsValid(next_x, next_y)) {
-      path_[path_length_].direction = dir;
-      path_length_++;
-      
-      // 递归搜索
-      if (DFS(next_x, next_y)) {
-        return true;
+  long long line_no = 1;
+  int row = 0;
+  while (row < rows && p < end) {
+    line_no++;
+    unsigned long long bits = 0;
+    int col = 0;
+    for (; p < end && *p != '\n'; ++p) {
+      char c = *p;
+      if (c == ' ' || c == '\t' || c == '\r') {
+        continue;
+      }
+      if (col == cols) {
+        break;
+      }
+      if (c == '1' || c == '#') {
+        bits |= 1ULL << (col & 63);
+      } else if (c != '0' && c != '.') {
+        break;
+      }
+      col++;
+      if ((col & 63) == 0) {
+        grid_.AddWallWord(row, (col >> 6) - 1, bits);
+        bits = 0;
       }
-      
-      // 回溯：撤销选择
-      path_length_--;
     }
+    if (p < end && *p != '\n') {
+      Allocate(0, 0);
+      std::cout << "地图文件第 " << line_no << " 行含有多余或无效的字符！" << std::endl;
+      return false;
+    }
+    p = p < end ? p + 1 : end;
+    if (col == 0) {
+      continue;  // 空行
+    }
+    if (col < cols) {
+      Allocate(0, 0);
+      std::cout << "地图文件第 " << line_no << " 行只有 " << col << " 格，应为 " << cols << " 格！" << std::endl;
+      return false;
+    }
+    if ((col & 63) != 0) {
+      grid_.AddWallWord(row, col >> 6, bits);
+    }
+    row++;
+  }
+  if (row < rows) {
+    Allocate(0, 0);
+    std::cout << "地图文件只有 " << row << " 行，应为 " << rows << " 行！" << std::endl;
+    return false;
   }
   
-  // 回溯：取消访问标记
-  visited_[x][y] = false;
-  return false;
+  // 可选的起点、终点坐标
+  SetStart(0, 0);
+  SetEnd(rows - 1, cols - 1);
+  int x = 0;
+  int y = 0;
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+    ++p;
+  }
+  if (ReadInt(&p, end, &x) && ReadInt(&p, end, &y)) {
+    SetStart(x, y);
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+      ++p;
+    }
+    if (ReadInt(&p, end, &x) && ReadInt(&p, end, &y)) {
+      SetEnd(x, y);
+    }
+  }
+  return true;
 }
 
 /**
- * 求解迷宫
- * @return 如果找到路径返回true，否则返回false
+ * 读一个小端 32 位整数
  */
-bool Maze::SolveMaze() {
-  std::memset(visited_, false, sizeof(visited_));
-  path_length_ = 0;
-  return DFS(start_x_, start_y_);
+static int ReadLittleEndian32(const char *p) {
+  const unsigned char *bytes = (const unsigned char *)p;
+  return (int)((unsigned int)bytes[0] | (unsigned int)bytes[1] << 8 | (unsigned int)bytes[2] << 16 |
+               (unsigned int)bytes[3] << 24);
 }
 
 /**
- * 打印路径
+ * 二进制位图：魔数之后是 6 个小端 32 位整数（行数、列数、起点行、起点列、终点行、终点列），
+ * 随后每行 (列数 + 7) / 8 字节，第 j 列对应该行第 j / 8 字节的第 j % 8 位（低位在前），1 为墙。
+ * 每 8 字节拼成位图的一个字，按小端字节序直接对应位图的列顺序。
  */
-void Maze::PrintPath() {
-  if (path_length_ == 0) {
-    std::cout << "没有找到路径！" << std::endl;
-    return;
+bool Maze::LoadBinaryMap(const char *data, const char *end) {
+  const long long kHeaderSize = 6 * 4;
+  if (end - data < kHeaderSize) {
+    Allocate(0, 0);
+    std::cout << "二进制地图文件头不完整！" << std::endl;
+    return false;
   }
+  int rows = ReadLittleEndian32(data);
+  int cols = ReadLittleEndian32(data + 4);
+  long long stride = ((long long)cols + 7) / 8;
+  // 先核对数据长度再分配，免得文件头谎报的行列数申请出几 GB 内存
+  if (rows <= 0 || cols <= 0 || end - data - kHeaderSize < rows * stride || !Resize(rows, cols)) {
+    Allocate(0, 0);
+    std::cout << "二进制地图的行列数无效或数据不完整！" << std::endl;
+    return false;
+  }
+  SetStart(ReadLittleEndian32(data + 8), ReadLittleEndian32(data + 12));
+  SetEnd(ReadLittleEndian32(data + 16), ReadLittleEndian32(data + 20));
   
-  std::cout << "迷宫路径：" << std::endl;
-  for (int i = 0; i < path_length_; ++i) {
-    std::cout << "(" << path_[i].x + 1 << "," << path_[i].y + 1 << ")";
-    if (i < path_length_ - 1) {
-      std::cout << " ---> ";
+  const unsigned char *bytes = (const unsigned char *)(data + kHeaderSize);
+  for (int i = 0; i < rows; ++i, bytes += stride) {
+    for (long long byte = 0; byte < stride; byte += 8) {
+      unsigned long long bits = 0;
+      for (long long k = 0; k < 8 && byte + k < stride; ++k) {
+        bits |= (unsigned long long)bytes[byte + k] << (8 * k);
+      }
+      grid_.AddWallWord(i, (int)(byte / 8), bits);
     }
   }
-  std::cout << std::endl;
+  return true;
 }
 
 /**
- * 打印迷宫地图（包含路径标记）
+ * 深度优先搜索（回溯法），用显式栈代替递归
+ * 栈中只保存每一层前进的方向：前进时压入方向并移动，回溯时弹出方向并反向移动，
+ * 再从下一个方向继续尝试。格子一经访问便保持标记，每个格子至多入栈一次，
+ * 因此时间与栈空间都与格子数成正比，不会因地图过大而栈溢出。
+ * @param x 起点行坐标
+ * @param y 起点列坐标
+ * @return 如果找到路径返回true，否则返回false
  */
-void Maze::PrintMaze() {
-  std::cout << "迷宫地图：" << std::endl;
+bool Maze::DFS(int x, int y) {
+  long long depth = 0;
+  int dir = 0;
+  grid_.MarkVisited(x, y);
+  nodes_expanded_ = 1;
   
-  // 创建显示数组
-  char display[kMaxSize][kMaxSize];
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      if (maze_[i][j] == 1) {
-        display[i][j] = '#';  // 墙壁
-      } else {
-        display[i][j] = 'o';  // 空地，使用o代替特殊字符ø
+  while (true) {
+    // 到达终点
+    if (x == end_x_ && y == end_y_) {
+      BuildPath(start_x_, start_y_, depth);
+      return true;
+    }
+    
+    // 从 dir 开始依次尝试四个方向，取第一个可走的
+    unsigned int neighbors = grid_.OpenNeighbors(x, y) >> dir;
+    dir = neighbors != 0 ? dir + __builtin_ctz(neighbors) : kDirections;
+    
+    if (dir < kDirections) {
+      // 前进：记录方向并进入下一个格子
+      steps_[depth++] = dir;
+      x += kDx[dir];
+      y += kDy[dir];
+      grid_.MarkVisited(x, y);
+      nodes_expanded_++;
+      dir = 0;
+    } else {
+      // 回溯：退回上一个格子，改试下一个方向
+      if (depth == 0) {
+        return false;
       }
+      int back = steps_[--depth];
+      x -= kDx[back];
+      y -= kDy[back];
+      dir = back + 1;
     }
   }
-  
-  // 标记路径
-  for (int i = 0; i < path_length_; ++i) {
-    display[path_[i].x][path_[i].y] = 'x';  // 路径，使用x代替特殊字符×
+}
+
+/**
+ * 按搜索栈中的方向从起点重走一遍，生成路径
+ * @param x 起点行坐标
+ * @param y 起点列坐标
+ * @param depth 栈深（路径步数）
+ */
+void Maze::BuildPath(int x, int y, long long depth) {
+  delete[] path_;
+  path_ = new Position[depth + 1];
+  for (long long i = 0; i < depth; ++i) {
+    path_[i].x = x;
+    path_[i].y = y;
+    path_[i].direction = steps_[i];
+    x += kDx[steps_[i]];
+    y += kDy[steps_[i]];
   }
+  path_[depth].x = x;
+  path_[depth].y = y;
+  path_[depth].direction = -1;
+  path_length_ = depth + 1;
+}
+
+/**
+ * 广度优先搜索：按层扩展，第一次到达终点时的路径即最短路径
+ * 队列中保存格子下标，每个格子至多入队一次。
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::BFS() {
+  unsigned int *queue = new unsigned int[CellCount()];
+  long long head = 0;
+  long long tail = 0;
+  grid_.MarkVisited(start_x_, start_y_);
+  queue[tail++] = (unsigned int)Index(start_x_, start_y_);
   
-  // 打印表头
-  std::cout << "    ";
-  for (int j = 0; j < cols_; ++j) {
-    std::cout << j << "列  ";
+  bool found = false;
+  while (head < tail) {
+    unsigned int cell = queue[head++];
+    int x = cell / cols_;
+    int y = cell % cols_;
+    nodes_expanded_++;
+    if (x == end_x_ && y == end_y_) {
+      found = true;
+      break;
+    }
+    for (unsigned int neighbors = grid_.OpenNeighbors(x, y); neighbors != 0; neighbors &= neighbors - 1) {
+      int dir = __builtin_ctz(neighbors);
+      int next_x = x + kDx[dir];
+      int next_y = y + kDy[dir];
+      long long next = Index(next_x, next_y);
+      grid_.MarkVisited(next_x, next_y);
+      steps_[next] = dir;
+      queue[tail++] = (unsigned int)next;
+    }
   }
-  std::cout << std::endl;
   
-  // 打印地图
-  for (int i = 0; i < rows_; ++i) {
-    std::cout << i << "行  ";
-    for (int j = 0; j < cols_; ++j) {
-      std::cout << display[i][j] << "   ";
+  delete[] queue;
+  if (found) {
+    BuildPathFromParents();
+  }
+  return found;
+}
+
+const int kParallelChunk = 1024;              // 线程每次领取的边界格子数、每次预留的下一层槽位数
+const long long kParallelFrontier = 2 * kParallelChunk;  // 边界不足两组时至多一个线程有活，由主线程单独扩展，
+                                                         // 省去两次屏障同步
+const unsigned int kEmptySlot = 0xFFFFFFFFu;  // 下一层数组中预留而未填满的槽位
+
+/**
+ * 并行 BFS 一层的共享状态
+ * 本层边界按 kParallelChunk 个一组由各线程原子地领取；新访问的格子写入下一层数组中
+ * 线程自己原子预留的一段槽位，层末把没填满的槽位填成 kEmptySlot，下一层读到时跳过。
+ * 每层每个线程至多留下一段不满的槽位，所以下一层数组只需比格子数多 线程数 * kParallelChunk 个槽位。
+ */
+struct ParallelBfsLevel {
+  BitGrid *grid;
+  unsigned char *steps;            // 各格子的到达方向，只由标记该格子的线程写入
+  int cols;
+  long long end;                   // 终点下标
+  const unsigned int *frontier;    // 本层边界
+  long long frontier_size;
+  unsigned int *next;              // 下一层边界
+  long long next_tail;             // 下一层已预留到的位置（原子）
+  long long read_cursor;           // 本层已领取到的位置（原子）
+  long long expanded;              // 累计扩展的格子数（原子）
+  bool found;                      // 已标记到终点（原子）
+  bool stop;                       // 通知工作线程退出
+  pthread_barrier_t start_barrier;   // 主线程发布一层后放行
+  pthread_barrier_t finish_barrier;  // 所有线程扩展完一层后放行
+  pthread_mutex_t launch_mutex;      // 创建线程期间由主线程持有，屏障初始化后才放工作线程进入
+};
+
+/**
+ * 领取并扩展本层边界直到领完，调用的每个线程各自执行
+ * @param alone 只有主线程在扩展本层：预留的槽位首尾相接，层末直接截掉没写满的部分
+ */
+static void ExpandParallelLevel(ParallelBfsLevel *level, bool alone) {
+  unsigned int *out = nullptr;
+  unsigned int *out_end = nullptr;
+  long long expanded = 0;
+  while (true) {
+    long long begin = __atomic_fetch_add(&level->read_cursor, (long long)kParallelChunk, __ATOMIC_RELAXED);
+    if (begin >= level->frontier_size) {
+      break;
+    }
+    long long end = begin + kParallelChunk < level->frontier_size ? begin + kParallelChunk : level->frontier_size;
+    for (long long i = begin; i < end; ++i) {
+      unsigned int cell = level->frontier[i];
+      if (cell == kEmptySlot) {
+        continue;
+      }
+      int x = cell / level->cols;
+      int y = cell % level->cols;
+      expanded++;
+      for (int dir = 0; dir < kDirections; ++dir) {
+        int next_x = x + kDx[dir];
+        int next_y = y + kDy[dir];
+        if (!level->grid->ClaimVisited(next_x, next_y)) {
+          continue;
+        }
+        long long next = (long long)next_x * level->cols + next_y;
+        level->steps[next] = dir;
+        if (next == level->end) {
+          __atomic_store_n(&level->found, true, __ATOMIC_RELAXED);
+        }
+        if (out == out_end) {
+          out = level->next + __atomic_fetch_add(&level->next_tail, (long long)kParallelChunk, __ATOMIC_RELAXED);
+          out_end = out + kParallelChunk;
+        }
+        *out++ = (unsigned int)next;
+      }
+    }
+  }
+  if (alone) {
+    if (out != nullptr) {
+      level->next_tail = out - level->next;
+    }
+  } else {
+    while (out < out_end) {
+      *out++ = kEmptySlot;
     }
-    std::cout << std::endl;
   }
+  __atomic_add_fetch(&level->expanded, expanded, __ATOMIC_RELAXED);
 }
 
 /**
- * 主函数
+ * 工作线程：每层在起始屏障处等待主线程发布边界，扩展完在结束屏障处汇合
  */
-int main() {
-  Maze maze;
-  
-  std::cout << "====== 勇闯迷宫游戏 ======" << std::endl << std::endl;
-  
-  // 输入迷宫数据
-  maze.InputMaze();
-  
+static void *RunParallelBfsWorker(void *arg) {
+  ParallelBfsLevel *level = (ParallelBfsLevel *)arg;
+  pthread_mutex_lock(&level->launch_mutex);
+  pthread_mutex_unlock(&level->launch_mutex);
+  while (true) {
+    pthread_barrier_wait(&level->start_barrier);
+    if (level->stop) {
+      break;
+    }
+    ExpandParallelLevel(level, false);
+    pthread_barrier_wait(&level->finish_barrier);
+  }
+  return nullptr;
+}
+
+/**
+ * 按层同步的并行广度优先搜索
+ * 每层的边界由 threads_ 个线程（主线程也参与）分组领取扩展，访问标记用原子或操作设置，
+ * 每个格子只被一个线程标记，该线程写下它的到达方向。两次屏障之间只有本层的扩展，
+ * 所以到达终点的那一层结束时 steps_ 已是一棵最短路径树，用 BuildPathFromParents 生成路径。
+ * 边界较小的层（如走廊里）由主线程单独扩展，避免每层都付出屏障同步的开销。
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::ParallelBFS() {
+  nodes_expanded_ = 1;
+  if (start_x_ == end_x_ && start_y_ == end_y_) {
+    BuildPathFromParents();
+    return true;
+  }
+  
+  long long capacity = CellCount() + (long long)threads_ * kParallelChunk;
+  unsigned int *frontier = new unsigned int[capacity];
+  unsigned int *next = new unsigned int[capacity];
+  ParallelBfsLevel level;
+  level.grid = &grid_;
+  level.steps = steps_;
+  level.cols = cols_;
+  level.end = Index(end_x_, end_y_);
+  level.expanded = 0;
+  level.found = false;
+  level.stop = false;
+  
+  pthread_t workers[kMaxThreads];
+  int started = 1;  // 参与扩展的线程数（含主线程）
+  if (threads_ > 1) {
+    // 屏障按实际创建成功的线程数初始化；初始化完之前工作线程停在启动锁上
+    pthread_mutex_init(&level.launch_mutex, nullptr);
+    pthread_mutex_lock(&level.launch_mutex);
+    while (started < threads_ && pthread_create(&workers[started], nullptr, RunParallelBfsWorker, &level) == 0) {
+      ++started;
+    }
+    if (started < threads_) {
+      std::cout << "并行 BFS 只创建了 " << started - 1 << " 个工作线程（请求 " << threads_ - 1 << " 个）" << std::endl;
+    }
+    pthread_barrier_init(&level.start_barrier, nullptr, started);
+    pthread_barrier_init(&level.finish_barrier, nullptr, started);
+    pthread_mutex_unlock(&level.launch_mutex);
+  }
+  
+  grid_.MarkVisited(start_x_, start_y_);
+  frontier[0] = (unsigned int)Index(start_x_, start_y_);
+  long long frontier_size = 1;
+  while (frontier_size > 0 && !level.found) {
+    levels_++;
+    level.frontier = frontier;
+    level.frontier_size = frontier_size;
+    level.next = next;
+    level.next_tail = 0;
+    level.read_cursor = 0;
+    if (started > 1 && frontier_size >= kParallelFrontier) {
+      parallel_levels_++;
+      pthread_barrier_wait(&level.start_barrier);
+      ExpandParallelLevel(&level, false);
+      pthread_barrier_wait(&level.finish_barrier);
+    } else {
+      ExpandParallelLevel(&level, true);
+    }
+    unsigned int *swap = frontier;
+    frontier = next;
+    next = swap;
+    frontier_size = level.next_tail;
+  }
+  
+  if (threads_ > 1) {
+    level.stop = true;
+    pthread_barrier_wait(&level.start_barrier);
+    for (int t = 1; t < started; ++t) {
+      pthread_join(workers[t], nullptr);
+    }
+    pthread_barrier_destroy(&level.start_barrier);
+    pthread_barrier_destroy(&level.finish_barrier);
+    pthread_mutex_destroy(&level.launch_mutex);
+  }
+  delete[] frontier;
+  delete[] next;
+  
+  nodes_expanded_ = level.expanded;
+  if (level.found) {
+    BuildPathFromParents();
+  }
+  return level.found;
+}
+
+/**
+ * 曼哈顿距离：四方向单位步长下到终点步数的下界
+ */
+int Maze::Heuristic(int x, int y) const {
+  return std::abs(x - end_x_) + std::abs(y - end_y_);
+}
+
+/**
+ * A* 搜索：每次扩展 f = g + h 最小的格子
+ * 曼哈顿距离是一致的启发函数，格子第一次出堆时 g 即为最短步数，
+ * 之后再出堆的同一格子是过期的堆元素，直接跳过；网格的访问标记即已出堆（关闭）的格子。
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::AStar() {
+  int *distance = new int[CellCount()];  // g 值，-1 表示尚未到达
+  std::memset(distance, 0xFF, sizeof(int) * CellCount());
+  OpenList open;
+  
+  OpenList::Entry entry;
+  entry.h = Heuristic(start_x_, start_y_);
+  entry.f = entry.h;
+  entry.cell = (unsigned int)Index(start_x_, start_y_);
+  distance[entry.cell] = 0;
+  open.Push(entry);
+  
+  bool found = false;
+  while (!open.Empty()) {
+    entry = open.Pop();
+    int x = entry.cell / cols_;
+    int y = entry.cell % cols_;
+    if (grid_.IsVisited(x, y)) {
+      continue;
+    }
+    grid_.MarkVisited(x, y);
+    nodes_expanded_++;
+    if (x == end_x_ && y == end_y_) {
+      found = true;
+      break;
+    }
+    
+    int g = distance[entry.cell] + 1;
+    for (unsigned int neighbors = grid_.OpenNeighbors(x, y); neighbors != 0; neighbors &= neighbors - 1) {
+      int dir = __builtin_ctz(neighbors);
+      int next_x = x + kDx[dir];
+      int next_y = y + kDy[dir];
+      long long next = Index(next_x, next_y);
+      if (distance[next] < 0 || g < distance[next]) {
+        distance[next] = g;
+        steps_[next] = dir;
+        OpenList::Entry child;
+        child.h = Heuristic(next_x, next_y);
+        child.f = g + child.h;
+        child.cell = (unsigned int)next;
+        open.Push(child);
+      }
+    }
+  }
+  
+  delete[] distance;
+  if (found) {
+    BuildPathFromParents();
+  }
+  return found;
+}
+
+/**
+ * 跳点搜索的水平跳跃：从 (x, y) 沿 dy 方向走，找到第一个跳点
+ * 跳点是终点，或有强制邻居的格子：上/下方格子可走，而它身后一格的上/下方是墙
+ * （那个上/下方格子只能经由本格最短到达）。按位图的字整字扫描：把本行的墙、
+ * 上下两行的强制邻居与终点合成候选位，找沿 dy 方向的第一个候选位；它是墙说明被挡住。
+ * 越过左右边界的列（含行尾填充位）都是墙，上下越界的行是全墙的保护行。
+ * @return 跳点所在列，被墙挡住返回 -1
+ */
+int Maze::JumpHorizontal(int x, int y, int dy) const {
+  int col = y + dy;
+  if (col < 0) {
+    return -1;
+  }
+  int words = grid_.words_per_row();
+  for (int word = col >> 6; word >= 0 && word < words; word += dy) {
+    unsigned long long wall = grid_.WallWord(x, word);
+    unsigned long long up = grid_.WallWord(x - 1, word);
+    unsigned long long down = grid_.WallWord(x + 1, word);
+    // 身后一格（列 c - dy）上下方是否为墙，移到第 c 位
+    unsigned long long up_behind;
+    unsigned long long down_behind;
+    if (dy > 0) {
+      up_behind = up << 1 | (word > 0 ? grid_.WallWord(x - 1, word - 1) >> 63 : 0);
+      down_behind = down << 1 | (word > 0 ? grid_.WallWord(x + 1, word - 1) >> 63 : 0);
+    } else {
+      up_behind = up >> 1 | (word + 1 < words ? grid_.WallWord(x - 1, word + 1) << 63 : 0);
+      down_behind = down >> 1 | (word + 1 < words ? grid_.WallWord(x + 1, word + 1) << 63 : 0);
+    }
+    unsigned long long candidates = wall | (~up & up_behind) | (~down & down_behind);
+    if (x == end_x_ && word == end_y_ >> 6) {
+      candidates |= 1ULL << (end_y_ & 63);
+    }
+    if (word == col >> 6) {
+      // 去掉出发点及其身后的列
+      candidates &= dy > 0 ? ~0ULL << (col & 63) : ~0ULL >> (63 - (col & 63));
+    }
+    if (candidates != 0) {
+      int bit = dy > 0 ? __builtin_ctzll(candidates) : 63 - __builtin_clzll(candidates);
+      return ((wall >> bit) & 1) != 0 ? -1 : word * 64 + bit;
+    }
+  }
+  return -1;
+}
+
+/**
+ * 跳点搜索的竖直跳跃：从 (x, y) 沿 dx 方向逐格走，
+ * 某格是终点，或从它出发的水平跳跃能找到跳点时，该格即跳点。
+ * @return 跳点所在行，被墙挡住返回 -1
+ */
+int Maze::JumpVertical(int x, int y, int dx) const {
+  for (x += dx; !grid_.IsWall(x, y); x += dx) {
+    if ((x == end_x_ && y == end_y_) || JumpHorizontal(x, y, 1) >= 0 || JumpHorizontal(x, y, -1) >= 0) {
+      return x;
+    }
+  }
+  return -1;
+}
+
+/**
+ * 四连通网格上的跳点搜索（JPS）
+ * 规定最短路径中竖直移动优先：竖直走的格子可以继续竖直走，也可以转向左右；
+ * 水平走的格子只继续水平走，除非遇到强制邻居才转向竖直。这样同一对格子之间
+ * 大量等长的路径只保留一条，开放区域里的整段直线被一次跳过，只有跳点进入开放表。
+ * 开放表与 A* 相同（曼哈顿距离启发），代价为跳跃的格数；parent 记录跳点的上一个跳点，
+ * steps_ 记录到达跳点的方向，找到终点后把每段直线展开成 steps_，再用 BuildPathFromParents 生成路径。
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::JumpPointSearch() {
+  int *distance = new int[CellCount()];  // 跳点的 g 值，-1 表示尚未到达
+  unsigned int *parent = new unsigned int[CellCount()];
+  std::memset(distance, 0xFF, sizeof(int) * CellCount());
+  OpenList open;
+  
+  long long start = Index(start_x_, start_y_);
+  OpenList::Entry entry;
+  entry.h = Heuristic(start_x_, start_y_);
+  entry.f = entry.h;
+  entry.cell = (unsigned int)start;
+  distance[start] = 0;
+  open.Push(entry);
+  
+  bool found = false;
+  while (!open.Empty()) {
+    entry = open.Pop();
+    int x = entry.cell / cols_;
+    int y = entry.cell % cols_;
+    if (grid_.IsVisited(x, y)) {
+      continue;
+    }
+    grid_.MarkVisited(x, y);
+    nodes_expanded_++;
+    if (x == end_x_ && y == end_y_) {
+      found = true;
+      break;
+    }
+    
+    // 按到达方向裁剪后继方向：起点四个方向都走
+    bool directions[kDirections] = {true, true, true, true};
+    if (entry.cell != start) {
+      int from = steps_[entry.cell];
+      if (kDx[from] != 0) {
+        directions[(from + 2) % kDirections] = false;  // 竖直到达：不回头
+      } else {
+        // 水平到达：继续水平走，竖直方向只走强制邻居
+        for (int dir = 0; dir < kDirections; ++dir) {
+          directions[dir] = dir == from ||
+              (kDx[dir] != 0 && !grid_.IsWall(x + kDx[dir], y) && grid_.IsWall(x + kDx[dir], y - kDy[from]));
+        }
+      }
+    }
+    
+    for (int dir = 0; dir < kDirections; ++dir) {
+      if (!directions[dir]) {
+        continue;
+      }
+      int next_x = x;
+      int next_y = y;
+      if (kDx[dir] != 0) {
+        next_x = JumpVertical(x, y, kDx[dir]);
+        if (next_x < 0) {
+          continue;
+        }
+      } else {
+        next_y = JumpHorizontal(x, y, kDy[dir]);
+        if (next_y < 0) {
+          continue;
+        }
+      }
+      long long next = Index(next_x, next_y);
+      int g = distance[entry.cell] + std::abs(next_x - x) + std::abs(next_y - y);
+      if (distance[next] < 0 || g < distance[next]) {
+        distance[next] = g;
+        parent[next] = entry.cell;
+        steps_[next] = dir;
+        OpenList::Entry child;
+        child.h = Heuristic(next_x, next_y);
+        child.f = g + child.h;
+        child.cell = (unsigned int)next;
+        open.Push(child);
+      }
+    }
+  }
+  
+  if (found) {
+    // 把跳点之间的每段直线展开：段上各格的到达方向都是该段的方向
+    long long cell = Index(end_x_, end_y_);
+    while (cell != start) {
+      long long from = parent[cell];
+      int dir = steps_[cell];
+      long long step = (long long)kDx[dir] * cols_ + kDy[dir];
+      for (long long c = cell; c != from; c -= step) {
+        steps_[c] = dir;
+      }
+      cell = from;
+    }
+    BuildPathFromParents();
+  }
+  delete[] distance;
+  delete[] parent;
+  return found;
+}
+
+/**
+ * 双向广度优先搜索：起点一侧与终点一侧各自按层扩展，每轮扩展当前较小的一侧的一整层，
+ * 某一侧扩展到对方已访问的格子即相遇。
+ * 相遇时对方的边界只含同一层的格子（更近的格子早已扩展过，其邻居若已被本侧访问，
+ * 相遇会在当时就被发现），因此第一次相遇给出的就是最短路径。
+ * 两侧的队列共用一个数组：起点一侧从前往后、终点一侧从后往前，每个格子至多入队一次。
+ * steps_ 在起点一侧记录到达该格子的方向，在终点一侧记录从该格子走向终点一侧上一格的方向。
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::BidirectionalBFS() {
+  if (start_x_ == end_x_ && start_y_ == end_y_) {
+    nodes_expanded_ = 1;
+    BuildPath(start_x_, start_y_, 0);
+    return true;
+  }
+  if (grid_.IsWall(end_x_, end_y_)) {
+    return false;
+  }
+  
+  grid_.AllocateBackMarks();  // SolveMaze 已清空访问标记，新分配的位集全为 0
+  unsigned int *queue = new unsigned int[CellCount()];
+  long long front_head = 0;
+  long long front_tail = 0;
+  long long back_head = CellCount() - 1;  // 终点一侧 [back_tail, back_head] 倒序存放
+  long long back_tail = CellCount() - 1;
+  grid_.MarkVisited(start_x_, start_y_);
+  queue[front_tail++] = (unsigned int)Index(start_x_, start_y_);
+  grid_.MarkBackVisited(end_x_, end_y_);
+  queue[back_tail--] = (unsigned int)Index(end_x_, end_y_);
+  
+  bool found = false;
+  while (!found && front_head < front_tail && back_tail < back_head) {
+    bool forward = front_tail - front_head <= back_head - back_tail;
+    if (forward) {
+      // 扩展起点一侧的一整层
+      long long level_end = front_tail;
+      while (!found && front_head < level_end) {
+        unsigned int cell = queue[front_head++];
+        int x = cell / cols_;
+        int y = cell % cols_;
+        nodes_expanded_++;
+        for (int dir = 0; dir < kDirections; ++dir) {
+          int next_x = x + kDx[dir];
+          int next_y = y + kDy[dir];
+          if (grid_.IsWall(next_x, next_y)) {
+            continue;
+          }
+          if (grid_.IsBackVisited(next_x, next_y)) {
+            BuildMeetingPath(x, y, dir);
+            found = true;
+            break;
+          }
+          if (!grid_.IsVisited(next_x, next_y)) {
+            grid_.MarkVisited(next_x, next_y);
+            steps_[Index(next_x, next_y)] = dir;
+            queue[front_tail++] = (unsigned int)Index(next_x, next_y);
+          }
+        }
+      }
+    } else {
+      // 扩展终点一侧的一整层
+      long long level_end = back_tail;
+      while (!found && back_head > level_end) {
+        unsigned int cell = queue[back_head--];
+        int x = cell / cols_;
+        int y = cell % cols_;
+        nodes_expanded_++;
+        for (int dir = 0; dir < kDirections; ++dir) {
+          int next_x = x + kDx[dir];
+          int next_y = y + kDy[dir];
+          if (grid_.IsWall(next_x, next_y)) {
+            continue;
+          }
+          // 从 next 走回当前格子的方向（kDx/kDy 中相反方向相差 2）
+          int back_dir = (dir + 2) % kDirections;
+          if (grid_.IsVisited(next_x, next_y)) {
+            BuildMeetingPath(next_x, next_y, back_dir);
+            found = true;
+            break;
+          }
+          if (!grid_.IsBackVisited(next_x, next_y)) {
+            grid_.MarkBackVisited(next_x, next_y);
+            steps_[Index(next_x, next_y)] = back_dir;
+            queue[back_tail--] = (unsigned int)Index(next_x, next_y);
+          }
+        }
+      }
+    }
+  }
+  
+  delete[] queue;
+  return found;
+}
+
+/**
+ * 沿 steps_ 从 (x, y) 数到 (to_x, to_y) 的步数
+ * @param toward_end 为true时按终点一侧的方向前进，否则按起点一侧的来向倒退
+ */
+long long Maze::CountSteps(int x, int y, int to_x, int to_y, bool toward_end) const {
+  long long steps = 0;
+  while (x != to_x || y != to_y) {
+    int dir = steps_[Index(x, y)];
+    if (toward_end) {
+      x += kDx[dir];
+      y += kDy[dir];
+    } else {
+      x -= kDx[dir];
+      y -= kDy[dir];
+    }
+    steps++;
+  }
+  return steps;
+}
+
+/**
+ * 双向搜索相遇后拼接路径：起点 ... (x, y) -> 沿 dir 一步 -> ... 终点
+ * (x, y) 属于起点一侧，下一格属于终点一侧。
+ */
+void Maze::BuildMeetingPath(int x, int y, int dir) {
+  int meet_x = x + kDx[dir];
+  int meet_y = y + kDy[dir];
+  long long front = CountSteps(x, y, start_x_, start_y_, false);
+  long long back = CountSteps(meet_x, meet_y, end_x_, end_y_, true);
+  long long depth = front + 1 + back;
+  
+  delete[] path_;
+  path_ = new Position[depth + 1];
+  path_length_ = depth + 1;
+  
+  // 起点一侧：从 (x, y) 倒退着写到 path_[0]
+  path_[front].x = x;
+  path_[front].y = y;
+  path_[front].direction = dir;
+  for (long long i = front; i > 0; --i) {
+    int from = steps_[Index(x, y)];
+    x -= kDx[from];
+    y -= kDy[from];
+    path_[i - 1].x = x;
+    path_[i - 1].y = y;
+    path_[i - 1].direction = from;
+  }
+  
+  // 终点一侧：从相遇格子顺着方向写到终点
+  x = meet_x;
+  y = meet_y;
+  for (long long i = front + 1; i < depth; ++i) {
+    int to = steps_[Index(x, y)];
+    path_[i].x = x;
+    path_[i].y = y;
+    path_[i].direction = to;
+    x += kDx[to];
+    y += kDy[to];
+  }
+  path_[depth].x = x;
+  path_[depth].y = y;
+  path_[depth].direction = -1;
+}
+
+/**
+ * 从终点沿 steps_ 记录的来向倒退回起点，生成路径
+ * 先数出步数，再倒序写入 path_。
+ */
+void Maze::BuildPathFromParents() {
+  long long depth = 0;
+  int x = end_x_;
+  int y = end_y_;
+  while (x != start_x_ || y != start_y_) {
+    int dir = steps_[Index(x, y)];
+    x -= kDx[dir];
+    y -= kDy[dir];
+    depth++;
+  }
+  
+  delete[] path_;
+  path_ = new Position[depth + 1];
+  path_length_ = depth + 1;
+  x = end_x_;
+  y = end_y_;
+  path_[depth].x = x;
+  path_[depth].y = y;
+  path_[depth].direction = -1;
+  for (long long i = depth; i > 0; --i) {
+    int dir = steps_[Index(x, y)];
+    x -= kDx[dir];
+    y -= kDy[dir];
+    path_[i - 1].x = x;
+    path_[i - 1].y = y;
+    path_[i - 1].direction = dir;
+  }
+}
+
+/**
+ * 求解迷宫
+ * @param solver 求解策略
+ * @return 如果找到路径返回true，否则返回false
+ */
+bool Maze::SolveMaze(SolverType solver) {
+  path_length_ = 0;
+  nodes_expanded_ = 0;
+  levels_ = 0;
+  parallel_levels_ = 0;
+  solve_micros_ = 0;
+  if (rows_ == 0 || cols_ == 0 || !InBounds(start_x_, start_y_) || !InBounds(end_x_, end_y_)) {
+    return false;
+  }
+  
+  long long start = NowMicros();
+  grid_.ClearVisited();
+  bool found = false;
+  switch (solver) {
+    case kBfsSolver:
+      found = BFS();
+      break;
+    case kAStarSolver:
+      found = AStar();
+      break;
+    case kBidirectionalSolver:
+      found = BidirectionalBFS();
+      break;
+    case kParallelBfsSolver:
+      found = ParallelBFS();
+      break;
+    case kJumpPointSolver:
+      found = JumpPointSearch();
+      break;
+    default:
+      found = DFS(start_x_, start_y_);
+      break;
+  }
+  solve_micros_ = NowMicros() - start;
+  return found;
+}
+
+/**
+ * 打印路径
+ */
+void Maze::PrintPath() {
+  if (path_length_ == 0) {
+    std::cout << "没有找到路径！" << std::endl;
+    return;
+  }
+  
+  std::cout << "迷宫路径：" << std::endl;
+  for (long long i = 0; i < path_length_; ++i) {
+    std::cout << "(" << path_[i].x + 1 << "," << path_[i].y + 1 << ")";
+    if (i < path_length_ - 1) {
+      std::cout << " ---> ";
+    }
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * 打印迷宫地图（包含路径标记）
+ */
+void Maze::PrintMaze() {
+  std::cout << "迷宫地图：" << std::endl;
+  if (rows_ > kMaxPrintSize || cols_ > kMaxPrintSize) {
+    std::cout << "(" << rows_ << " x " << cols_ << " 的地图过大，不打印网格)" << std::endl;
+    return;
+  }
+  
+  // 创建显示数组
+  char *display = new char[CellCount()];
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < cols_; ++j) {
+      if (grid_.IsWall(i, j)) {
+        display[Index(i, j)] = '#';  // 墙壁
+      } else {
+        display[Index(i, j)] = 'o';  // 空地，使用o代替特殊字符ø
+      }
+    }
+  }
+  
+  // 标记路径
+  for (long long i = 0; i < path_length_; ++i) {
+    display[Index(path_[i].x, path_[i].y)] = 'x';  // 路径，使用x代替特殊字符×
+  }
+  
+  // 打印表头
+  std::cout << "    ";
+  for (int j = 0; j < cols_; ++j) {
+    std::cout << j << "列  ";
+  }
   std::cout << std::endl;
   
+  // 打印地图
+  for (int i = 0; i < rows_; ++i) {
+    std::cout << i << "行  ";
+    for (int j = 0; j < cols_; ++j) {
+      std::cout << display[Index(i, j)] << "   ";
+    }
+    std::cout << std::endl;
+  }
+  delete[] display;
+}
+
+// 多次查询的结果
+enum QueryResult {
+  kQueryFound,        // 可达，给出最短路径长度
+  kQueryUnreachable,  // 两端位于不同的连通分量
+  kQueryInvalid,      // 端点越界或是墙
+};
+
+const int kMaxDistanceFields = 8;         // 缓存的距离场个数
+const unsigned int kUnreached = 0xFFFFFFFFu;  // 距离场中未到达的格子
+
+/**
+ * 同一张静态地图上的多次起终点查询
+ * 预处理只做一次：按连通分量给通路格子编号，两端不在同一分量的查询 O(1) 判定无解。
+ * 可达的查询优先查 BFS 距离场：迷宫是无向图，以终点或起点为源的距离场都能直接查表；
+ * 都不在缓存时，终点若最近查过一次就对它建场，否则只做一次双向 BFS。
+ * 双向 BFS 用递增的搜索编号标记访问过的格子，查询之间不需要清空标记。
+ * 距离场最多缓存 kMaxDistanceFields 个，满了按轮转淘汰；终点固定的一串查询
+ * 从第二次起都是查表，终点各不相同的查询也不会每次都付出整分量 BFS 的代价。
+ */
+class PathQueryService {
+ public:
+  explicit PathQueryService(const BitGrid &grid);
+  ~PathQueryService();
+  
+  void Build();
+  QueryResult Query(int start_x, int start_y, int end_x, int end_y, long long *length);
+  
+  unsigned int component_count() const { return component_count_; }
+  int fields_built() const { return fields_built_; }
+  long long searches() const { return searches_; }
+  long long build_micros() const { return build_micros_; }
+  
+ private:
+  // 以 source 为源的 BFS 距离场
+  struct DistanceField {
+    long long source;
+    unsigned int *distance;
+  };
+  
+  const BitGrid &grid_;
+  int rows_;
+  int cols_;
+  unsigned int *labels_;                         // 通路格子的分量编号（从 1 开始），墙为 0
+  unsigned int *queue_;                          // 标号、建场与双向 BFS 共用的队列
+  unsigned int *stamp_;                          // 双向 BFS 的访问标记：本次搜索编号（起点侧）或编号 + 1（终点侧）
+  unsigned int *depth_;                          // 双向 BFS 中格子到所在一侧源点的步数
+  unsigned int search_stamp_;                    // 下一次双向 BFS 的起点侧编号
+  DistanceField fields_[kMaxDistanceFields];
+  int field_count_;                              // 已缓存的距离场个数
+  int next_victim_;                              // 缓存满时下一个被替换的距离场
+  long long recent_targets_[kMaxDistanceFields];  // 最近未命中缓存的终点
+  int recent_count_;
+  int next_recent_;
+  unsigned int component_count_;
+  int fields_built_;                             // 累计建场次数
+  long long searches_;                           // 累计双向 BFS 次数
+  long long build_micros_;                       // 分量标号用时（微秒）
+  
+  long long Index(int x, int y) const { return (long long)x * cols_ + y; }
+  bool IsEndpoint(int x, int y) const {
+    return x >= 0 && x < rows_ && y >= 0 && y < cols_ && !grid_.IsWall(x, y);
+  }
+  void LabelComponent(long long source, unsigned int label);
+  const unsigned int *FindField(long long source) const;
+  const unsigned int *BuildField(long long source);
+  bool RecentTarget(long long target);
+  long long Search(long long source, long long target);
+  
+  PathQueryService(const PathQueryService &);
+  PathQueryService &operator=(const PathQueryService &);
+};
+
+PathQueryService::PathQueryService(const BitGrid &grid)
+    : grid_(grid), rows_(grid.rows()), cols_(grid.cols()), labels_(nullptr), queue_(nullptr),
+      stamp_(nullptr), depth_(nullptr), search_stamp_(1), field_count_(0), next_victim_(0),
+      recent_count_(0), next_recent_(0), component_count_(0), fields_built_(0), searches_(0),
+      build_micros_(0) {}
+
+PathQueryService::~PathQueryService() {
+  for (int i = 0; i < field_count_; ++i) {
+    delete[] fields_[i].distance;
+  }
+  delete[] labels_;
+  delete[] queue_;
+  delete[] stamp_;
+  delete[] depth_;
+}
+
+/**
+ * 预处理：给每个连通分量编号
+ */
+void PathQueryService::Build() {
+  long long start = NowMicros();
+  long long cells = (long long)rows_ * cols_;
+  delete[] labels_;
+  delete[] queue_;
+  delete[] stamp_;
+  delete[] depth_;
+  labels_ = new unsigned int[cells];
+  queue_ = new unsigned int[cells];
+  stamp_ = new unsigned int[cells];
+  depth_ = new unsigned int[cells];
+  std::memset(labels_, 0, sizeof(unsigned int) * cells);
+  std::memset(stamp_, 0, sizeof(unsigned int) * cells);
+  search_stamp_ = 1;
+  component_count_ = 0;
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < cols_; ++j) {
+      if (labels_[Index(i, j)] == 0 && !grid_.IsWall(i, j)) {
+        LabelComponent(Index(i, j), ++component_count_);
+      }
+    }
+  }
+  build_micros_ = NowMicros() - start;
+}
+
+/**
+ * 从 source 出发按 BFS 给所在分量的格子标上 label
+ */
+void PathQueryService::LabelComponent(long long source, unsigned int label) {
+  long long head = 0;
+  long long tail = 0;
+  labels_[source] = label;
+  queue_[tail++] = (unsigned int)source;
+  while (head < tail) {
+    unsigned int cell = queue_[head++];
+    int x = cell / cols_;
+    int y = cell % cols_;
+    for (int dir = 0; dir < kDirections; ++dir) {
+      int next_x = x + kDx[dir];
+      int next_y = y + kDy[dir];
+      if (!grid_.IsWall(next_x, next_y) && labels_[Index(next_x, next_y)] == 0) {
+        labels_[Index(next_x, next_y)] = label;
+        queue_[tail++] = (unsigned int)Index(next_x, next_y);
+      }
+    }
+  }
+}
+
+/**
+ * 查找以 source 为源的已缓存距离场，没有返回 nullptr
+ */
+const unsigned int *PathQueryService::FindField(long long source) const {
+  for (int i = 0; i < field_count_; ++i) {
+    if (fields_[i].source == source) {
+      return fields_[i].distance;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * 对 source 所在分量做一次 BFS 建立距离场并放入缓存
+ */
+const unsigned int *PathQueryService::BuildField(long long source) {
+  long long cells = (long long)rows_ * cols_;
+  DistanceField *field;
+  if (field_count_ < kMaxDistanceFields) {
+    field = &fields_[field_count_++];
+    field->distance = new unsigned int[cells];
+  } else {
+    field = &fields_[next_victim_];
+    next_victim_ = (next_victim_ + 1) % kMaxDistanceFields;
+  }
+  field->source = source;
+  unsigned int *distance = field->distance;
+  std::memset(distance, 0xFF, sizeof(unsigned int) * cells);
+  fields_built_++;
+  
+  long long head = 0;
+  long long tail = 0;
+  distance[source] = 0;
+  queue_[tail++] = (unsigned int)source;
+  while (head < tail) {
+    unsigned int cell = queue_[head++];
+    int x = cell / cols_;
+    int y = cell % cols_;
+    for (int dir = 0; dir < kDirections; ++dir) {
+      int next_x = x + kDx[dir];
+      int next_y = y + kDy[dir];
+      if (!grid_.IsWall(next_x, next_y) && distance[Index(next_x, next_y)] == kUnreached) {
+        distance[Index(next_x, next_y)] = distance[cell] + 1;
+        queue_[tail++] = (unsigned int)Index(next_x, next_y);
+      }
+    }
+  }
+  return distance;
+}
+
+/**
+ * 终点是否在最近未命中缓存的终点里；不在则记下它
+ */
+bool PathQueryService::RecentTarget(long long target) {
+  for (int i = 0; i < recent_count_; ++i) {
+    if (recent_targets_[i] == target) {
+      return true;
+    }
+  }
+  if (recent_count_ < kMaxDistanceFields) {
+    recent_targets_[recent_count_++] = target;
+  } else {
+    recent_targets_[next_recent_] = target;
+    next_recent_ = (next_recent_ + 1) % kMaxDistanceFields;
+  }
+  return false;
+}
+
+/**
+ * 双向 BFS 求 source 到 target 的最短路径格子数（两端已知在同一分量）
+ * 与 Maze::BidirectionalBFS 相同，每轮扩展较小一侧的一整层，第一次相遇即最短；
+ * 两侧的队列共用 queue_，起点一侧从前往后、终点一侧从后往前。
+ */
+long long PathQueryService::Search(long long source, long long target) {
+  if (source == target) {
+    return 1;
+  }
+  long long cells = (long long)rows_ * cols_;
+  if (search_stamp_ >= 0xFFFFFFFEu) {
+    std::memset(stamp_, 0, sizeof(unsigned int) * cells);
+    search_stamp_ = 1;
+  }
+  unsigned int forward_stamp = search_stamp_;
+  unsigned int backward_stamp = search_stamp_ + 1;
+  search_stamp_ += 2;
+  searches_++;
+  
+  long long front_head = 0;
+  long long front_tail = 0;
+  long long back_head = cells - 1;
+  long long back_tail = cells - 1;
+  stamp_[source] = forward_stamp;
+  depth_[source] = 0;
+  queue_[front_tail++] = (unsigned int)source;
+  stamp_[target] = backward_stamp;
+  depth_[target] = 0;
+  queue_[back_tail--] = (unsigned int)target;
+  
+  while (front_head < front_tail && back_tail < back_head) {
+    bool forward = front_tail - front_head <= back_head - back_tail;
+    unsigned int own = forward ? forward_stamp : backward_stamp;
+    unsigned int other = forward ? backward_stamp : forward_stamp;
+    long long level_end = forward ? front_tail : back_tail;
+    while (forward ? front_head < level_end : back_head > level_end) {
+      unsigned int cell = forward ? queue_[front_head++] : queue_[back_head--];
+      int x = cell / cols_;
+      int y = cell % cols_;
+      for (int dir = 0; dir < kDirections; ++dir) {
+        int next_x = x + kDx[dir];
+        int next_y = y + kDy[dir];
+        if (grid_.IsWall(next_x, next_y)) {
+          continue;
+        }
+        long long next = Index(next_x, next_y);
+        if (stamp_[next] == other) {
+          return (long long)depth_[cell] + 1 + depth_[next] + 1;
+        }
+        if (stamp_[next] != own) {
+          stamp_[next] = own;
+          depth_[next] = depth_[cell] + 1;
+          if (forward) {
+            queue_[front_tail++] = (unsigned int)next;
+          } else {
+            queue_[back_tail--] = (unsigned int)next;
+          }
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * 回答一次查询
+ * @param length 可达时输出最短路径的格子数（含起点和终点）
+ */
+QueryResult PathQueryService::Query(int start_x, int start_y, int end_x, int end_y, long long *length) {
+  if (!IsEndpoint(start_x, start_y) || !IsEndpoint(end_x, end_y)) {
+    return kQueryInvalid;
+  }
+  long long source = Index(start_x, start_y);
+  long long target = Index(end_x, end_y);
+  if (labels_[source] != labels_[target]) {
+    return kQueryUnreachable;
+  }
+  
+  const unsigned int *distance = FindField(target);
+  if (distance != nullptr) {
+    *length = (long long)distance[source] + 1;
+  } else if ((distance = FindField(source)) != nullptr) {
+    *length = (long long)distance[target] + 1;
+  } else if (RecentTarget(target)) {
+    *length = (long long)BuildField(target)[source] + 1;
+  } else {
+    *length = Search(source, target);
+  }
+  return kQueryFound;
+}
+
+/**
+ * 无符号整数基数排序（每轮 8 位，共 4 轮）
+ */
+static void RadixSort(unsigned int *values, unsigned int *scratch, long long n) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    long long count[257] = {0};
+    for (long long i = 0; i < n; ++i) {
+      count[((values[i] >> shift) & 0xFF) + 1]++;
+    }
+    for (int b = 0; b < 256; ++b) {
+      count[b + 1] += count[b];
+    }
+    for (long long i = 0; i < n; ++i) {
+      scratch[count[(values[i] >> shift) & 0xFF]++] = values[i];
+    }
+    unsigned int *swap = values;
+    values = scratch;
+    scratch = swap;
+  }
+}
+
+/**
+ * 查询模式：对已输入的迷宫做一次预处理，再逐行回答查询文件中的起终点对
+ * 查询文件每行 "起点行 起点列 终点行 终点列"（从0开始），空行和 # 开头的行忽略。
+ * 每行输出路径长度（格子数）、"无解" 或 "无效"，最后输出预处理用时与单次查询的延迟分位数。
+ * @return 文件可读返回0，否则返回1
+ */
+static int RunQueries(const Maze &maze, const char *path) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    std::cout << "无法打开查询文件：" << path << std::endl;
+    return 1;
+  }
+  
+  double cycles_per_ns = CyclesPerNano();
+  PathQueryService service(maze.grid());
+  service.Build();
+  
+  const char *data = file.data();
+  const char *data_end = data + file.size();
+  long long capacity = 1024;
+  long long count = 0;
+  unsigned int *cycles = new unsigned int[capacity];
+  long long results[3] = {0, 0, 0};
+  long long bad_lines = 0;
+  long long line_no = 0;
+  long long start = NowMicros();
+  for (const char *line = data; line < data_end;) {
+    const char *newline = (const char *)std::memchr(line, '\n', data_end - line);
+    const char *p = line;
+    const char *end = newline != nullptr ? newline : data_end;
+    line = end + 1;
+    line_no++;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+      ++p;
+    }
+    if (p == end || *p == '#') {
+      continue;
+    }
+    
+    int start_x, start_y, end_x, end_y;
+    if (!ReadInt(&p, end, &start_x) || !ReadInt(&p, end, &start_y) ||
+        !ReadInt(&p, end, &end_x) || !ReadInt(&p, end, &end_y)) {
+      std::cout << "第 " << line_no << " 行格式错误" << '\n';
+      bad_lines++;
+      continue;
+    }
+    
+    long long length = 0;
+    unsigned long long before = ReadCycles();
+    QueryResult result = service.Query(start_x, start_y, end_x, end_y, &length);
+    unsigned long long elapsed = ReadCycles() - before;
+    if (count == capacity) {
+      unsigned int *grown = new unsigned int[capacity * 2];
+      std::memcpy(grown, cycles, sizeof(unsigned int) * count);
+      delete[] cycles;
+      cycles = grown;
+      capacity *= 2;
+    }
+    cycles[count++] = elapsed > 0xFFFFFFFFull ? 0xFFFFFFFFu : (unsigned int)elapsed;
+    results[result]++;
+    
+    std::cout << start_x << " " << start_y << " " << end_x << " " << end_y << "\t";
+    if (result == kQueryFound) {
+      std::cout << length << '\n';
+    } else {
+      std::cout << (result == kQueryUnreachable ? "无解" : "无效") << '\n';
+    }
+  }
+  long long elapsed_us = NowMicros() - start;
+  
+  std::cout << std::endl << "预处理：" << service.component_count() << " 个连通分量，用时 "
+            << service.build_micros() / 1000.0 << " ms" << std::endl;
+  std::cout << "查询 " << count << " 次（可达 " << results[kQueryFound] << "，无解 "
+            << results[kQueryUnreachable] << "，无效 " << results[kQueryInvalid] << "），格式错误 "
+            << bad_lines << " 行，建立距离场 " << service.fields_built() << " 次，双向 BFS "
+            << service.searches() << " 次，总用时 "
+            << elapsed_us / 1000.0 << " ms" << std::endl;
+  if (count > 0) {
+    unsigned int *scratch = new unsigned int[count];
+    RadixSort(cycles, scratch, count);
+    delete[] scratch;
+    const double kQuantiles[4] = {0.5, 0.9, 0.99, 0.999};
+    const char *const kQuantileNames[4] = {"p50", "p90", "p99", "p99.9"};
+    std::cout << "单次查询延迟(ns)：";
+    for (int q = 0; q < 4; ++q) {
+      long long index = (long long)(kQuantiles[q] * (count - 1));
+      std::cout << kQuantileNames[q] << " " << (long long)(cycles[index] / cycles_per_ns) << "  ";
+    }
+    std::cout << "max " << (long long)(cycles[count - 1] / cycles_per_ns) << std::endl;
+  }
+  delete[] cycles;
+  return 0;
+}
+
+/**
+ * 输出一次求解的统计
+ */
+static void PrintSolveStats(const Maze &maze, SolverType solver) {
+  std::cout << "求解器：" << kSolverNames[solver]
+            << "  扩展格子数：" << maze.nodes_expanded()
+            << "  用时：" << maze.solve_micros() / 1000.0 << " ms";
+  if (solver == kParallelBfsSolver) {
+    std::cout << "  多线程扩展的层数：" << maze.parallel_levels() << " / " << maze.levels();
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * 依次用所有求解器求解同一迷宫，比较路径长度、扩展格子数与用时
+ */
+static void CompareSolvers(Maze &maze) {
+  std::cout << "求解器\t路径长度\t扩展格子数\t用时(ms)" << std::endl;
+  for (int i = 0; i < kSolverCount; ++i) {
+    bool found = maze.SolveMaze((SolverType)i);
+    std::cout << kSolverNames[i] << "\t";
+    if (found) {
+      std::cout << maze.path_length();
+    } else {
+      std::cout << "无解";
+    }
+    std::cout << "\t\t" << maze.nodes_expanded() << "\t\t" << maze.solve_micros() / 1000.0 << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * xorshift32 伪随机数
+ */
+static unsigned int NextRandom(unsigned int *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/**
+ * 迷宫生成算法
+ */
+enum GeneratorType {
+  kBacktrackerGenerator,  // 递归回溯（显式栈）：完美迷宫，通道长而曲折
+  kPrimGenerator,         // 随机 Prim：完美迷宫，分叉多、死胡同短
+  kObstacleGenerator,     // 随机障碍：每格按密度随机设墙，可能无解
+  kGeneratorCount
+};
+
+const char *const kGeneratorNames[kGeneratorCount] = {"backtracker", "prim", "random"};
+
+/**
+ * 按名称解析生成算法
+ * @return 名称有效返回true
+ */
+static bool ParseGenerator(const char *name, GeneratorType *type) {
+  for (int i = 0; i < kGeneratorCount; ++i) {
+    if (std::strcmp(name, kGeneratorNames[i]) == 0) {
+      *type = (GeneratorType)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * 在通路地图上按 density% 的概率随机设墙，左上角与右下角附近留出空地，免得起点、终点被障碍围住
+ */
+static void AddObstacles(Maze &maze, int density, unsigned int *state) {
+  int rows = maze.grid().rows();
+  int cols = maze.grid().cols();
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      if (NextRandom(state) % 100 < (unsigned int)density && i + j > 3 && (rows - 1 - i) + (cols - 1 - j) > 3) {
+        maze.SetWall(i, j);
+      }
+    }
+  }
+}
+
+/**
+ * 完美迷宫中的房间：偶数行偶数列的格子，相邻房间之间隔一道墙
+ * 房间编号 = (x / 2) * 每行房间数 + y / 2
+ */
+static int RoomNeighbors(const Maze &maze, int x, int y, bool want_open, int *dirs) {
+  int count = 0;
+  for (int dir = 0; dir < kDirections; ++dir) {
+    int next_x = x + 2 * kDx[dir];
+    int next_y = y + 2 * kDy[dir];
+    if (next_x >= 0 && next_x < maze.grid().rows() && next_y >= 0 && next_y < maze.grid().cols() &&
+        maze.grid().IsWall(next_x, next_y) != want_open) {
+      dirs[count++] = dir;
+    }
+  }
+  return count;
+}
+
+/**
+ * 递归回溯生成：从左上角出发，随机走向一个未打通的相邻房间并打通中间的墙，
+ * 四周都已打通时退回上一个房间。用显式栈代替递归，栈深不超过房间数。
+ */
+static void CarveBacktracker(Maze &maze, unsigned int *state) {
+  int room_cols = (maze.grid().cols() + 1) / 2;
+  long long rooms = (long long)((maze.grid().rows() + 1) / 2) * room_cols;
+  unsigned int *stack = new unsigned int[rooms];
+  long long top = 0;
+  int dirs[kDirections];
+  stack[top++] = 0;
+  maze.ClearWall(0, 0);
+  while (top > 0) {
+    int x = stack[top - 1] / room_cols * 2;
+    int y = stack[top - 1] % room_cols * 2;
+    int count = RoomNeighbors(maze, x, y, false, dirs);
+    if (count == 0) {
+      --top;
+      continue;
+    }
+    int dir = dirs[NextRandom(state) % count];
+    maze.ClearWall(x + kDx[dir], y + kDy[dir]);
+    maze.ClearWall(x + 2 * kDx[dir], y + 2 * kDy[dir]);
+    stack[top++] = (unsigned int)((x / 2 + kDx[dir]) * room_cols + y / 2 + kDy[dir]);
+  }
+  delete[] stack;
+}
+
+/**
+ * 随机 Prim 生成：维护与已打通区域相邻的房间集合，每次随机取出一个，
+ * 向它已打通的邻居中随机一个打通中间的墙，再把它未打通的邻居加入集合。
+ * 集合用数组保存，取出时与末尾交换；in_set 位集保证每个房间只加入一次。
+ */
+static void CarvePrim(Maze &maze, unsigned int *state) {
+  int room_cols = (maze.grid().cols() + 1) / 2;
+  long long rooms = (long long)((maze.grid().rows() + 1) / 2) * room_cols;
+  unsigned int *frontier = new unsigned int[rooms];
+  unsigned long long *in_set = new unsigned long long[rooms / 64 + 1];
+  std::memset(in_set, 0, sizeof(unsigned long long) * (rooms / 64 + 1));
+  long long size = 0;
+  int dirs[kDirections];
+  int x = 0;
+  int y = 0;
+  in_set[0] = 1;
+  maze.ClearWall(0, 0);
+  for (;;) {
+    int count = RoomNeighbors(maze, x, y, false, dirs);
+    for (int i = 0; i < count; ++i) {
+      unsigned int room = (unsigned int)((x / 2 + kDx[dirs[i]]) * room_cols + y / 2 + kDy[dirs[i]]);
+      if ((in_set[room >> 6] >> (room & 63) & 1) == 0) {
+        in_set[room >> 6] |= 1ULL << (room & 63);
+        frontier[size++] = room;
+      }
+    }
+    if (size == 0) {
+      break;
+    }
+    long long pick = NextRandom(state) % size;
+    unsigned int room = frontier[pick];
+    frontier[pick] = frontier[--size];
+    x = room / room_cols * 2;
+    y = room % room_cols * 2;
+    count = RoomNeighbors(maze, x, y, true, dirs);
+    int dir = dirs[NextRandom(state) % count];
+    maze.ClearWall(x + kDx[dir], y + kDy[dir]);
+    maze.ClearWall(x, y);
+  }
+  delete[] frontier;
+  delete[] in_set;
+}
+
+/**
+ * 生成 rows x cols 的迷宫
+ * 完美迷宫（backtracker/prim）只在偶数行偶数列上放房间，行列数为偶数时最后一行/列保持为墙；
+ * 起点为左上角，终点为右下角的房间。
+ * @param seed    随机种子，相同的种子、算法与大小生成相同的迷宫
+ * @param density 随机障碍的墙占比（百分数），只用于 random
+ * @return 行列数有效返回true
+ */
+static bool GenerateMaze(Maze &maze, GeneratorType type, int rows, int cols, unsigned int seed, int density) {
+  if (!maze.Resize(rows, cols)) {
+    return false;
+  }
+  unsigned int state = seed * 2654435761u + 2463534242u;  // 让相邻种子的随机序列也相差很远
+  if (state == 0) {
+    state = 2463534242u;
+  }
+  if (type == kObstacleGenerator) {
+    AddObstacles(maze, density, &state);
+    maze.SetStart(0, 0);
+    maze.SetEnd(rows - 1, cols - 1);
+    return true;
+  }
+  maze.FillWalls();
+  if (type == kBacktrackerGenerator) {
+    CarveBacktracker(maze, &state);
+  } else {
+    CarvePrim(maze, &state);
+  }
+  maze.SetStart(0, 0);
+  maze.SetEnd((rows - 1) / 2 * 2, (cols - 1) / 2 * 2);
+  return true;
+}
+
+/**
+ * 以 --map 可读的文本格式输出迷宫：首行行列数，随后每行每格一个字符（# 墙，. 通路），最后是起点、终点
+ */
+static void WriteTextMap(const Maze &maze) {
+  int rows = maze.grid().rows();
+  int cols = maze.grid().cols();
+  char *line = new char[cols + 1];
+  line[cols] = '\n';
+  std::cout << rows << " " << cols << "\n";
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      line[j] = maze.grid().IsWall(i, j) ? '#' : '.';
+    }
+    std::cout.write(line, cols + 1);
+  }
+  std::cout << maze.start_x() << " " << maze.start_y() << "\n"
+            << maze.end_x() << " " << maze.end_y() << std::endl;
+  delete[] line;
+}
+
+/**
+ * 压测用迷宫的形状
+ */
+enum BenchShape {
+  kOpenShape,      // 无墙的空旷地图
+  kCorridorShape,  // 蛇形走廊：每隔一行一道墙，缺口在左右两端交替
+  kRandomShape,    // 随机障碍：每格以 1/4 的概率为墙（固定种子）
+  kRoomsShape,     // 房间：63 x 63 的空旷房间，相邻房间之间的墙上各开一扇门
+  kBenchShapeCount
+};
+
+const char *const kBenchShapeNames[kBenchShapeCount] = {"空旷地图", "蛇形走廊", "随机障碍", "房间"};
+const int kRoomSize = 64;  // 房间边长（含一道墙）
+
+/**
+ * 构造 size x size 的压测迷宫
+ * 空旷地图的起点、终点位于中间一行的 1/4 与 3/4 处；其余从左上角走到右下角。
+ */
+static void BuildBenchMaze(Maze &maze, BenchShape shape, int size) {
+  maze.Resize(size, size);
+  unsigned int state = 2463534242u;
+  if (shape == kRandomShape) {
+    AddObstacles(maze, 25, &state);
+  }
+  if (shape == kRoomsShape) {
+    // 第 kRoomSize - 1, 2 * kRoomSize - 1, ... 行与列是墙，每段墙上随机开一扇门
+    for (int wall = kRoomSize - 1; wall < size; wall += kRoomSize) {
+      for (int room = 0; room < size; room += kRoomSize) {
+        int width = size - room < kRoomSize - 1 ? size - room : kRoomSize - 1;
+        int row_door = room + NextRandom(&state) % width;
+        int col_door = room + NextRandom(&state) % width;
+        for (int k = room; k < room + kRoomSize && k < size; ++k) {
+          if (k != row_door) {
+            maze.SetWall(wall, k);
+          }
+          if (k != col_door) {
+            maze.SetWall(k, wall);
+          }
+        }
+      }
+    }
+  }
+  if (shape == kCorridorShape) {
+    for (int i = 1; i < size; i += 2) {
+      int gap = (i / 2) % 2 == 0 ? size - 1 : 0;
+      for (int j = 0; j < size; ++j) {
+        if (j != gap) {
+          maze.SetWall(i, j);
+        }
+      }
+    }
+  }
+  if (shape == kOpenShape) {
+    maze.SetStart(size / 2, size / 4);
+    maze.SetEnd(size / 2, size - 1 - size / 4);
+  } else {
+    maze.SetStart(0, 0);
+    maze.SetEnd(size - 1, size - 1);
+  }
+}
+
+/**
+ * 在空旷地图、蛇形走廊、随机障碍与房间四类迷宫上比较各求解器
+ */
+static void RunBenchmark() {
+  const int kBenchSizes[] = {257, 1025, 2049};
+  Maze maze;
+  for (int shape = 0; shape < kBenchShapeCount; ++shape) {
+    for (int i = 0; i < (int)(sizeof(kBenchSizes) / sizeof(kBenchSizes[0])); ++i) {
+      BuildBenchMaze(maze, (BenchShape)shape, kBenchSizes[i]);
+      std::cout << "== " << kBenchShapeNames[shape] << " " << kBenchSizes[i] << " x " << kBenchSizes[i]
+                << " ==" << std::endl;
+      CompareSolvers(maze);
+    }
+  }
+}
+
+/**
+ * 生成迷宫语料并比较各求解器：递归回溯与 Prim 完美迷宫、四种密度的随机障碍地图，各取 255/1023/2047 三种大小
+ */
+static void RunCorpusBenchmark(unsigned int seed) {
+  const int kCorpusSizes[] = {255, 1023, 2047};
+  const int kDensities[] = {10, 20, 30, 40};
+  Maze maze;
+  for (int type = 0; type < kGeneratorCount; ++type) {
+    for (int i = 0; i < (int)(sizeof(kCorpusSizes) / sizeof(kCorpusSizes[0])); ++i) {
+      int variants = type == kObstacleGenerator ? (int)(sizeof(kDensities) / sizeof(kDensities[0])) : 1;
+      for (int v = 0; v < variants; ++v) {
+        long long start = NowMicros();
+        GenerateMaze(maze, (GeneratorType)type, kCorpusSizes[i], kCorpusSizes[i], seed, kDensities[v]);
+        std::cout << "== " << kGeneratorNames[type] << " " << kCorpusSizes[i] << " x " << kCorpusSizes[i];
+        if (type == kObstacleGenerator) {
+          std::cout << " 墙占 " << kDensities[v] << "%";
+        }
+        std::cout << " 种子 " << seed << "（生成用时 " << (NowMicros() - start) / 1000.0 << " ms）==" << std::endl;
+        CompareSolvers(maze);
+      }
+    }
+  }
+}
+
+/**
+ * 并行 BFS 压测：在大的空旷地图与随机障碍地图上，比较单线程 BFS 与 1..max_threads 线程的并行 BFS
+ */
+static void RunParallelBenchmark(int max_threads, int size) {
+  const BenchShape kShapes[] = {kOpenShape, kRandomShape};
+  Maze maze;
+  for (int s = 0; s < 2; ++s) {
+    BuildBenchMaze(maze, kShapes[s], size);
+    // 从中心走到角上：边界按菱形扩大到约 2 * size 格，多数层都足够宽，能分给多个线程
+    maze.ClearWall(size / 2, size / 2);
+    maze.SetStart(size / 2, size / 2);
+    maze.SetEnd(size - 1, size - 1);
+    maze.SolveMaze(kBfsSolver);
+    long long serial_micros = maze.solve_micros();
+    std::cout << "== " << kBenchShapeNames[kShapes[s]] << " " << size << " x " << size << " ==" << std::endl;
+    std::cout << "求解器\t线程数\t路径长度\t扩展格子数\t用时(ms)\t加速比\t多线程层数/总层数" << std::endl;
+    std::cout << "bfs\t1\t" << maze.path_length() << "\t\t" << maze.nodes_expanded() << "\t\t"
+              << serial_micros / 1000.0 << "\t\t1\t-" << std::endl;
+    // 线程数按 1, 2, 4, ... 翻倍，最后一轮恰好是 max_threads
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+      maze.set_threads(threads);
+      maze.SolveMaze(kParallelBfsSolver);
+      std::cout << "pbfs\t" << threads << "\t" << maze.path_length() << "\t\t" << maze.nodes_expanded() << "\t\t"
+                << maze.solve_micros() / 1000.0 << "\t\t"
+                << (double)serial_micros / (maze.solve_micros() > 0 ? maze.solve_micros() : 1) << "\t"
+                << maze.parallel_levels() << " / " << maze.levels() << std::endl;
+      if (threads == max_threads) {
+        break;
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
+/**
+ * 主函数
+ * 可选参数：
+ *   --solver dfs|bfs|astar|bidir|pbfs|jps  选择求解策略（默认 dfs）
+ *   --threads <N>                 并行 BFS 的线程数（默认为 CPU 核数）
+ *   --compare                     先用所有求解器求解并列表比较，再按所选策略输出路径
+ *   --bench                       在内置的空旷地图、蛇形走廊、随机障碍与房间地图上比较各求解器后退出
+ *   --bench-corpus [--seed N]     在生成的迷宫语料上比较各求解器后退出
+ *   --bench-parallel [--size S]   在 S x S（默认 4097）的大地图上报告并行 BFS 随线程数的加速比后退出
+ *   --generate backtracker|prim|random [--size S] [--seed N] [--density P]
+ *                                 生成 S x S（默认 4097）的迷宫，以 --map 可读的文本格式写到标准输出后退出；
+ *                                 P 为随机障碍的墙占比（默认 25）
+ *   --map <文件>                  从文件载入迷宫（文本或二进制位图，见 Maze::LoadMap），代替交互输入
+ *   --queries <文件>              输入迷宫后预处理一次，逐行回答文件中的起终点查询后退出
+ */
+int main(int argc, char *argv[]) {
+  SolverType solver = kDfsSolver;
+  bool compare = false;
+  const char *query_path = nullptr;
+  const char *map_path = nullptr;
+  int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int bench_size = 4097;
+  bool bench = false;
+  bool bench_parallel = false;
+  bool bench_corpus = false;
+  bool generate = false;
+  GeneratorType generator = kBacktrackerGenerator;
+  int seed = 1;
+  int density = 25;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+      if (!ParseSolver(argv[++i], &solver)) {
+        std::cout << "未知的求解器：" << argv[i] << "（可选 dfs/bfs/astar/bidir/pbfs/jps）" << std::endl;
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--compare") == 0) {
+      compare = true;
+    } else if (std::strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+      map_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--queries") == 0 && i + 1 < argc) {
+      query_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      if (!ParseArgInt(argv[++i], &threads) || threads < 1 || threads > kMaxThreads) {
+        std::cout << "线程数应在 1 到 " << kMaxThreads << " 之间：" << argv[i] << std::endl;
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+      if (!ParseArgInt(argv[++i], &bench_size)) {
+        bench_size = 0;
+      }
+    } else if (std::strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+    } else if (std::strcmp(argv[i], "--bench-parallel") == 0) {
+      bench_parallel = true;
+    } else if (std::strcmp(argv[i], "--bench-corpus") == 0) {
+      bench_corpus = true;
+    } else if (std::strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+      if (!ParseGenerator(argv[++i], &generator)) {
+        std::cout << "未知的生成算法：" << argv[i] << "（可选 backtracker/prim/random）" << std::endl;
+        return 1;
+      }
+      generate = true;
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      if (!ParseArgInt(argv[++i], &seed)) {
+        std::cout << "随机种子无效：" << argv[i] << std::endl;
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--density") == 0 && i + 1 < argc) {
+      if (!ParseArgInt(argv[++i], &density) || density < 0 || density > 100) {
+        std::cout << "墙占比应在 0 到 100 之间：" << argv[i] << std::endl;
+        return 1;
+      }
+    }
+  }
+  if (threads > kMaxThreads) {
+    threads = kMaxThreads;  // sysconf 报告的核数可能超过上限
+  }
+  if (bench) {
+    RunBenchmark();
+    return 0;
+  }
+  if (bench_corpus) {
+    RunCorpusBenchmark((unsigned int)seed);
+    return 0;
+  }
+  if (generate) {
+    Maze maze;
+    if (!GenerateMaze(maze, generator, bench_size, bench_size, (unsigned int)seed, density)) {
+      std::cout << "迷宫边长无效：" << bench_size << std::endl;
+      return 1;
+    }
+    WriteTextMap(maze);
+    return 0;
+  }
+  if (bench_parallel) {
+    if (bench_size < 2 || (long long)bench_size * bench_size > kMaxCells) {
+      std::cout << "压测地图边长无效：" << bench_size << std::endl;
+      return 1;
+    }
+    RunParallelBenchmark(threads, bench_size);
+    return 0;
+  }
+  
+  Maze maze;
+  maze.set_threads(threads);
+  
+  std::cout << "====== 勇闯迷宫游戏 ======" << std::endl << std::endl;
+  
+  // 输入迷宫数据
+  if (map_path != nullptr) {
+    long long start = NowMicros();
+    if (!maze.LoadMap(map_path)) {
+      return 1;
+    }
+    std::cout << "载入地图 " << map_path << "：" << maze.grid().rows() << " x " << maze.grid().cols()
+              << "，位图 " << maze.grid().MemoryBytes() / 1024.0 / 1024.0 << " MB，用时 " << (NowMicros() - start) / 1000.0 << " ms" << std::endl;
+  } else {
+    maze.InputMaze();
+  }
+  
+  std::cout << std::endl;
+  
+  if (query_path != nullptr) {
+    return RunQueries(maze, query_path);
+  }
+  
+  if (compare) {
+    CompareSolvers(maze);
+  }
+  
   // 求解迷宫
-  if (maze.SolveMaze()) {
-    std::cout << "成功找到路径！" << std::endl << std::endl;
+  if (maze.SolveMaze(solver)) {
+    std::cout << "成功找到路径！" << std::endl;
+    PrintSolveStats(maze, solver);
+    std::cout << std::endl;
     maze.PrintMaze();
     std::cout << std::endl;
     maze.PrintPath();
   } else {
     std::cout << "无法找到从起点到终点的路径！" << std::endl;
+    PrintSolveStats(maze, solver);
   }
   
   std::cout << std::endl << "Press any key to continue" << std::endl;